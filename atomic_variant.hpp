@@ -0,0 +1,352 @@
+/*!*****************************************************************************
+ * @file    atomic_variant.hpp
+ * @author  Owen Huang Wensong
+ * @date    14 OCT 2026
+ * @brief   Atomic variant of small trivially copyable alternatives for C++11.
+ *
+ * @par     Copyright (c) 2023 Owen Huang Wensong.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+*******************************************************************************/
+
+#ifndef HEADER_GUARD_OWS_ATOMIC_VARIANT_HPP
+#define HEADER_GUARD_OWS_ATOMIC_VARIANT_HPP
+
+#include "variant.hpp"
+
+#include <atomic> // single word cells
+#include <cstring>// memcpy
+
+// 16 byte cells, 0 std::atomic (may lock), 1 GCC/Clang cmpxchg16b (-mcx16), 2 MSVC _InterlockedCompareExchange128.
+#ifndef OWS_ATOMIC_VARIANT_DWCAS
+#if defined(__GCC_HAVE_SYNC_COMPARE_AND_SWAP_16)
+#define OWS_ATOMIC_VARIANT_DWCAS 1
+#elif defined(_MSC_VER) && defined(_M_X64) && !defined(__clang__)
+#define OWS_ATOMIC_VARIANT_DWCAS 2
+#else
+#define OWS_ATOMIC_VARIANT_DWCAS 0
+#endif
+#endif
+
+// reject AtomicVariant instantiations that would fall back to a lock
+#ifndef OWS_ATOMIC_VARIANT_REQUIRE_LOCK_FREE
+#define OWS_ATOMIC_VARIANT_REQUIRE_LOCK_FREE 0
+#endif
+
+#if 2 == OWS_ATOMIC_VARIANT_DWCAS
+#include <intrin.h>
+#endif
+
+namespace OWS
+{
+  // ***************************************************************************
+  // *************************************************************** detail ****
+
+  namespace detail
+  {
+    namespace avrnt
+    {
+      // ***** words *****
+      // payload bytes then the index, rounded up to the next power of two
+
+      constexpr size_t WordSize(size_t n) { return n <= 1 ? 1 : n <= 2 ? 2 : n <= 4 ? 4 : n <= 8 ? 8 : n <= 16 ? 16 : 0; }
+
+      struct alignas(16) Wide{ std::uint64_t m_Half[2]; };
+
+      // oversize, rejected by AtomicVariant's static_assert
+      template <size_t N>
+      struct Word{ using type = Wide; static constexpr bool s_LockFree{ false }; };
+
+      template <> struct Word<1>  { using type = std::uint8_t;  static constexpr bool s_LockFree{ 2 == ATOMIC_CHAR_LOCK_FREE }; };
+      template <> struct Word<2>  { using type = std::uint16_t; static constexpr bool s_LockFree{ 2 == ATOMIC_SHORT_LOCK_FREE }; };
+      template <> struct Word<4>  { using type = std::uint32_t; static constexpr bool s_LockFree{ 2 == ATOMIC_INT_LOCK_FREE }; };
+      template <> struct Word<8>  { using type = std::uint64_t; static constexpr bool s_LockFree{ 2 == ATOMIC_LLONG_LOCK_FREE }; };
+      template <> struct Word<16> { using type = Wide;          static constexpr bool s_LockFree{ 0 != OWS_ATOMIC_VARIANT_DWCAS }; };
+
+      // no padding bits, from the library trait, the compiler builtin before C++17, unchecked on compilers without either
+      template <typename T>
+      struct UniqueBytes : public std::integral_constant<bool,
+#if __cplusplus >= 201703L || (defined(_MSVC_LANG) && _MSVC_LANG >= 201703L)
+        std::has_unique_object_representations<T>::value
+#elif (defined(__GNUC__) && __GNUC__ >= 7) || defined(__clang__) || (defined(_MSC_VER) && _MSC_VER >= 1911)
+        __has_unique_object_representations(T)
+#else
+        true
+#endif
+      >{};
+
+      // ***** cells *****
+      // one atomic word, std::atomic unless a double width compare and swap is available
+
+      template <typename W>
+      struct Cell
+      {
+        Cell(W word) noexcept : m_Word{ word } {}
+
+        W Load(std::memory_order order) const noexcept { return m_Word.load(order); }
+        void Store(W word, std::memory_order order) noexcept { m_Word.store(word, order); }
+        W Exchange(W word, std::memory_order order) noexcept { return m_Word.exchange(word, order); }
+        bool CompareExchange(W& expected, W desired, std::memory_order order) noexcept { return m_Word.compare_exchange_strong(expected, desired, order); }
+
+        std::atomic<W> m_Word;
+      };
+
+#if 0 != OWS_ATOMIC_VARIANT_DWCAS
+      // full barrier compare and swap, every operation is sequentially consistent and loads write the line
+      template <>
+      struct Cell<Wide>
+      {
+        Cell(Wide word) noexcept : m_Word(word) {}
+
+        Wide Load(std::memory_order) const noexcept
+        {
+          Wide seen{ { 0, 0 } };
+          Cas(seen, seen);
+          return seen;
+        }
+
+        void Store(Wide word, std::memory_order order) noexcept { Exchange(word, order); }
+
+        Wide Exchange(Wide word, std::memory_order) noexcept
+        {
+          Wide seen{ { 0, 0 } };
+          while (!Cas(seen, word)) {}
+          return seen;
+        }
+
+        bool CompareExchange(Wide& expected, Wide desired, std::memory_order) noexcept { return Cas(expected, desired); }
+
+        // expected receives the current word on failure
+        bool Cas(Wide& expected, Wide desired) const noexcept
+        {
+#if 1 == OWS_ATOMIC_VARIANT_DWCAS
+          __extension__ typedef unsigned __int128 U128;
+          U128 want, next;
+          std::memcpy(&want, &expected, sizeof(Wide));
+          std::memcpy(&next, &desired, sizeof(Wide));
+          U128 const seen{ __sync_val_compare_and_swap(reinterpret_cast<U128*>(&m_Word), want, next) };
+          std::memcpy(&expected, &seen, sizeof(Wide));
+          return seen == want;
+#else
+          return 0 != _InterlockedCompareExchange128(reinterpret_cast<long long volatile*>(&m_Word),
+            static_cast<long long>(desired.m_Half[1]), static_cast<long long>(desired.m_Half[0]), reinterpret_cast<long long*>(expected.m_Half));
+#endif
+        }
+
+        mutable Wide m_Word;
+      };
+#endif
+
+      // ***** encoding *****
+      // zeroed word with the held alternative's bytes at 0 and the index after the largest one,
+      // so equal values always encode to equal words regardless of padding in the variant
+
+      template <typename... Ts>
+      struct Layout
+      {
+        using index_type = typename vrnt::IndexType<sizeof...(Ts)>::type;
+        using variant_type = Variant<Ts...>;
+        using word_traits = Word<WordSize(vrnt::RawSize<Ts...>::value + sizeof(index_type))>;
+        using word_type = typename word_traits::type;
+
+        static constexpr size_t s_IdxOffset{ vrnt::RawSize<Ts...>::value };
+        static constexpr index_type s_Valueless{ std::numeric_limits<index_type>::max() };
+
+        template <typename T>
+        static word_type Encode(T const& value) noexcept
+        {
+          word_type word;
+          std::memset(&word, 0, sizeof(word_type));
+          if (!std::is_empty<T>::value)std::memcpy(&word, &value, sizeof(T)); // empty alternatives have no value bytes
+          index_type const idx{ static_cast<index_type>(vrnt::IFromType<0, T, Ts...>::value) };
+          std::memcpy(reinterpret_cast<char*>(&word) + s_IdxOffset, &idx, sizeof(index_type));
+          return word;
+        }
+
+        static word_type Encode(variant_type const& variant) noexcept
+        {
+          if (variant.valueless())
+          {
+            word_type word;
+            std::memset(&word, 0, sizeof(word_type));
+            std::memcpy(reinterpret_cast<char*>(&word) + s_IdxOffset, &s_Valueless, sizeof(index_type));
+            return word;
+          }
+          return vrnt::Dispatch<EncodeOp>(variant.index(), &variant);
+        }
+
+        static index_type Index(word_type const& word) noexcept
+        {
+          index_type idx;
+          std::memcpy(&idx, reinterpret_cast<char const*>(&word) + s_IdxOffset, sizeof(index_type));
+          return idx;
+        }
+
+        static variant_type Decode(word_type const& word) noexcept
+        {
+          index_type const idx{ Index(word) };
+          return s_Valueless == idx ? variant_type{} : vrnt::Dispatch<DecodeOp>(idx, &word);
+        }
+
+        struct EncodeOp
+        {
+          using result_type = word_type;
+          using fnptr_type = word_type (*)(variant_type const*);
+          static constexpr size_t s_Count{ sizeof...(Ts) };
+
+          template <size_t I>
+          static word_type call(variant_type const* variant) noexcept { return Encode(vrnt::Access::get<I>(*variant)); }
+        };
+
+        struct DecodeOp
+        {
+          using result_type = variant_type;
+          using fnptr_type = variant_type (*)(word_type const*);
+          static constexpr size_t s_Count{ sizeof...(Ts) };
+
+          template <size_t I, typename T = typename vrnt::IthType<I, Ts...>::type>
+          static variant_type call(word_type const* word) noexcept
+          {
+            typename std::aligned_storage<sizeof(T), alignof(T)>::type value; // trivially copyable, need not be default constructible
+            std::memcpy(&value, word, sizeof(T));
+            return variant_type{ *reinterpret_cast<T const*>(&value) };
+          }
+        };
+      };
+    }
+  }
+
+  // *************************************************************** detail ****
+  // ***************************************************************************
+
+  // Alternatives whose bytes are their whole value, compare_exchange compares encoded words byte for byte and padding
+  // copied in with a value would make equal values differ. Empty types, float, double and types without padding
+  // qualify, specialize for other types whose padding is always zeroed, e.g. floating point structs packed tight.
+  template <typename T>
+  struct atomic_padding_free : public std::integral_constant<bool, std::is_empty<T>::value ||
+    std::is_same<T, float>::value || std::is_same<T, double>::value || detail::avrnt::UniqueBytes<T>::value>{};
+
+  // Variant of trivially copyable alternatives published through a single atomic word.
+  // Payload plus index must fit 16 bytes, 8 or less is lock free on every mainstream target, 16 needs a
+  // double width compare and swap (see OWS_ATOMIC_VARIANT_DWCAS), otherwise std::atomic may take a lock.
+  // is_always_lock_free reports which, OWS_ATOMIC_VARIANT_REQUIRE_LOCK_FREE turns the lock into a compile error.
+  template <typename... Ts>
+  class AtomicVariant
+  {
+    using Layout = detail::avrnt::Layout<Ts...>;
+    using word_type = typename Layout::word_type;
+
+  public:
+
+    using value_type = Variant<Ts...>;
+
+    static_assert(true == std::is_trivially_copyable<value_type>::value, "atomic variant alternatives should be trivially copyable");
+    static_assert(true == detail::vrnt::all_true<atomic_padding_free<Ts>::value...>::value,
+      "atomic variant alternatives should have no padding bytes, compare_exchange compares bytes, see atomic_padding_free");
+    static_assert(0 != detail::avrnt::WordSize(Layout::s_IdxOffset + sizeof(typename Layout::index_type)),
+      "atomic variant alternatives plus index should fit 16 bytes");
+
+    static constexpr bool is_always_lock_free{ Layout::word_traits::s_LockFree };
+
+    static_assert(!OWS_ATOMIC_VARIANT_REQUIRE_LOCK_FREE || is_always_lock_free,
+      "atomic variant would use a lock based fallback, 16 byte words need OWS_ATOMIC_VARIANT_DWCAS (e.g. -mcx16)");
+
+    // valueless
+    AtomicVariant() noexcept : m_Cell{ Layout::Encode(value_type{}) } {}
+
+    explicit AtomicVariant(value_type const& variant) noexcept : m_Cell{ Layout::Encode(variant) } {}
+
+    template <typename T, typename = typename std::enable_if<detail::vrnt::is_any<T, Ts...>::value>::type>
+    explicit AtomicVariant(T const& value) noexcept : m_Cell{ Layout::Encode(value) } {}
+
+    AtomicVariant(AtomicVariant const&) = delete;
+    AtomicVariant& operator=(AtomicVariant const&) = delete;
+
+    value_type load(std::memory_order order = std::memory_order_seq_cst) const noexcept
+    {
+      return Layout::Decode(m_Cell.Load(order));
+    }
+
+    // index of the held alternative without decoding the payload
+    unsigned index(std::memory_order order = std::memory_order_seq_cst) const noexcept
+    {
+      typename Layout::index_type const idx{ Layout::Index(m_Cell.Load(order)) };
+      return Layout::s_Valueless == idx ? std::numeric_limits<unsigned>::max() : idx;
+    }
+
+    void store(value_type const& variant, std::memory_order order = std::memory_order_seq_cst) noexcept
+    {
+      m_Cell.Store(Layout::Encode(variant), order);
+    }
+
+    template <typename T>
+    typename std::enable_if<detail::vrnt::is_any<T, Ts...>::value>::type store(T const& value, std::memory_order order = std::memory_order_seq_cst) noexcept
+    {
+      m_Cell.Store(Layout::Encode(value), order);
+    }
+
+    value_type exchange(value_type const& variant, std::memory_order order = std::memory_order_seq_cst) noexcept
+    {
+      return Layout::Decode(m_Cell.Exchange(Layout::Encode(variant), order));
+    }
+
+    // strong, expected receives the current value on failure, alternatives compare by their bytes
+    bool compare_exchange(value_type& expected, value_type const& desired, std::memory_order order = std::memory_order_seq_cst) noexcept
+    {
+      word_type seen{ Layout::Encode(expected) };
+      if (m_Cell.CompareExchange(seen, Layout::Encode(desired), order))return true;
+      expected = Layout::Decode(seen);
+      return false;
+    }
+
+    // replaces the value with desired only while it holds alternative T equal to expected
+    template <typename T, typename U>
+    typename std::enable_if<detail::vrnt::is_any<T, Ts...>::value && detail::vrnt::is_any<U, Ts...>::value, bool>::type
+      compare_exchange(T const& expected, U const& desired, std::memory_order order = std::memory_order_seq_cst) noexcept
+    {
+      word_type seen{ Layout::Encode(expected) };
+      return m_Cell.CompareExchange(seen, Layout::Encode(desired), order);
+    }
+
+  private:
+
+    detail::avrnt::Cell<word_type> m_Cell;
+  };
+
+#if OWS_SMOKE_TEST
+  static_assert(8 == sizeof(OWS::AtomicVariant<char, int>),                       "atomic variant: word size failure");
+  static_assert(2 == sizeof(OWS::AtomicVariant<char, bool>),                      "atomic variant: word size failure");
+  static_assert(true == OWS::AtomicVariant<std::uint32_t, std::uint16_t>::is_always_lock_free, "atomic variant: lock free failure");
+  static_assert(4 == OWS::detail::avrnt::Layout<std::uint32_t, std::uint16_t>::s_IdxOffset,  "atomic variant: layout failure");
+  static_assert(true  == OWS::atomic_padding_free<double>::value,                                "atomic variant: padding failure");
+#if __cplusplus >= 201703L || (defined(_MSVC_LANG) && _MSVC_LANG >= 201703L) || (defined(__GNUC__) && __GNUC__ >= 7) || defined(__clang__) || (defined(_MSC_VER) && _MSC_VER >= 1911)
+  namespace detail
+  {
+    namespace avrnt
+    {
+      struct SmokePadded{ char m_Tag; std::uint32_t m_Value; };
+    }
+  }
+
+  static_assert(false == OWS::atomic_padding_free<OWS::detail::avrnt::SmokePadded>::value,        "atomic variant: padding failure");
+#endif
+#endif // OWS_SMOKE_TEST
+}
+
+#endif // !HEADER_GUARD_OWS_ATOMIC_VARIANT_HPP
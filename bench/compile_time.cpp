@@ -0,0 +1,55 @@
+/*!*****************************************************************************
+ * @file    compile_time.cpp
+ * @brief   Compile time benchmark for variants with many alternatives.
+ *
+ * Time the compiler on this translation unit, it has no runtime output.
+ *   time g++ -std=c++11 -I.. -c compile_time.cpp -o /dev/null
+ *   time g++ -std=c++11 -I.. -DOWS_CT_BENCH_N=500 -c compile_time.cpp -o /dev/null
+ * Without OWS_CT_BENCH_N variants of 50, 200 and 500 alternatives are instantiated.
+*******************************************************************************/
+
+#include "variant.hpp"
+
+namespace
+{
+  template <size_t I>
+  struct Alt{ size_t m_Value; };
+
+  template <typename Seq>
+  struct MakeVariant;
+
+  template <size_t... Is>
+  struct MakeVariant<OWS::detail::vrnt::index_sequence<Is...>>{ using type = OWS::Variant<Alt<Is>...>; };
+
+  template <size_t N>
+  using BenchVariant = typename MakeVariant<typename OWS::detail::vrnt::make_index_sequence<N>::type>::type;
+
+  struct Reader
+  {
+    template <size_t I>
+    size_t operator()(Alt<I> const& alt) const { return alt.m_Value + I; }
+  };
+
+  // touch every member that instantiates type list metafunctions
+  template <size_t N>
+  size_t Exercise(size_t value)
+  {
+    BenchVariant<N> v{ Alt<N / 2>{ value } };
+    BenchVariant<N> copy{ v };
+    copy.template emplace<N - 1>(Alt<N - 1>{ value });
+    v = copy;
+    size_t result{ OWS::visit(Reader{}, v) };
+    if (v.template holds_alternative<Alt<N - 1>>())result += v.template get<N - 1>().m_Value;
+    if (auto p = copy.template get_if<Alt<0>>())result += p->m_Value;
+    return result;
+  }
+}
+
+size_t OwsCompileTimeBench(size_t value)
+{
+#ifdef OWS_CT_BENCH_N
+  return Exercise<OWS_CT_BENCH_N>(value);
+#else
+  return Exercise<50>(value) + Exercise<200>(value) + Exercise<500>(value);
+#endif
+}
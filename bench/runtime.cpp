@@ -0,0 +1,396 @@
+/*!*****************************************************************************
+ * @file    runtime.cpp
+ * @brief   Runtime benchmark of OWS::Variant against other variant libraries.
+ *
+ * Standalone harness, every competitor found by __has_include is measured.
+ *   g++ -std=c++11 -O2 -I.. runtime.cpp -o runtime && ./runtime
+ *   g++ -std=c++17 -O2 -I.. runtime.cpp -o runtime && ./runtime   (adds std::variant)
+ * std::variant needs C++17, boost::variant2 and mpark::variant need their headers on the include path.
+ * Timings are the best of several repeats in nanoseconds per element.
+ * Generated code size of each kernel, every kernel is a noinline Kernel* function:
+ *   nm -C -S --size-sort runtime | grep Kernel
+*******************************************************************************/
+
+#include "variant.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <vector>
+#include <utility>
+#include <algorithm>
+#include <functional>
+
+#if defined(__has_include)
+#if __has_include(<variant>) && __cplusplus >= 201703L
+#include <variant>
+#define OWS_BENCH_STD 1
+#endif
+#if __has_include(<boost/variant2/variant.hpp>) && __cplusplus >= 201103L
+#include <boost/variant2/variant.hpp>
+#define OWS_BENCH_VARIANT2 1
+#endif
+#if __has_include(<mpark/variant.hpp>)
+#include <mpark/variant.hpp>
+#define OWS_BENCH_MPARK 1
+#endif
+#endif
+
+#if defined(_MSC_VER)
+#define OWS_BENCH_NOINLINE __declspec(noinline)
+#else
+#define OWS_BENCH_NOINLINE __attribute__((noinline))
+#endif
+
+namespace
+{
+  // ***** harness *****
+
+  static constexpr size_t s_Elements{ 1 << 16 };
+  static constexpr int    s_Repeats{ 7 };
+
+  template <typename T>
+  inline void DoNotOptimize(T const& value)
+  {
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "r,m"(value) : "memory");
+#else
+    static volatile char sink;
+    sink = *reinterpret_cast<volatile char const*>(&value);
+#endif
+  }
+
+  // best of s_Repeats runs of fn, nanoseconds per element
+  template <typename Fn>
+  double Measure(Fn&& fn)
+  {
+    double best{ 1e300 };
+    for (int i{ 0 }; i < s_Repeats; ++i)
+    {
+      auto start{ std::chrono::steady_clock::now() };
+      fn();
+      std::chrono::duration<double, std::nano> elapsed{ std::chrono::steady_clock::now() - start };
+      best = std::min(best, elapsed.count() / s_Elements);
+    }
+    return best;
+  }
+
+  // ***** libraries *****
+
+  struct OwsLib
+  {
+    static char const* Name() { return "OWS::Variant"; }
+    template <typename... Ts> using type = OWS::Variant<Ts...>;
+    template <typename T, typename V> static T const* GetIf(V const& v) { return v.template get_if<T>(); }
+    template <typename T, typename V, typename A> static void Emplace(V& v, A&& a) { v.template emplace<T>(std::forward<A>(a)); }
+    template <typename F, typename... Vs> static auto Visit(F&& f, Vs&&... vs) -> decltype(OWS::visit(std::forward<F>(f), std::forward<Vs>(vs)...))
+    {
+      return OWS::visit(std::forward<F>(f), std::forward<Vs>(vs)...);
+    }
+  };
+
+#if OWS_BENCH_STD
+  struct StdLib
+  {
+    static char const* Name() { return "std::variant"; }
+    template <typename... Ts> using type = std::variant<Ts...>;
+    template <typename T, typename V> static T const* GetIf(V const& v) { return std::get_if<T>(&v); }
+    template <typename T, typename V, typename A> static void Emplace(V& v, A&& a) { v.template emplace<T>(std::forward<A>(a)); }
+    template <typename F, typename... Vs> static decltype(auto) Visit(F&& f, Vs&&... vs) { return std::visit(std::forward<F>(f), std::forward<Vs>(vs)...); }
+  };
+#endif
+
+#if OWS_BENCH_VARIANT2
+  struct Variant2Lib
+  {
+    static char const* Name() { return "boost::variant2"; }
+    template <typename... Ts> using type = boost::variant2::variant<Ts...>;
+    template <typename T, typename V> static T const* GetIf(V const& v) { return boost::variant2::get_if<T>(&v); }
+    template <typename T, typename V, typename A> static void Emplace(V& v, A&& a) { v.template emplace<T>(std::forward<A>(a)); }
+    template <typename F, typename... Vs> static auto Visit(F&& f, Vs&&... vs) -> decltype(boost::variant2::visit(std::forward<F>(f), std::forward<Vs>(vs)...))
+    {
+      return boost::variant2::visit(std::forward<F>(f), std::forward<Vs>(vs)...);
+    }
+  };
+#endif
+
+#if OWS_BENCH_MPARK
+  struct MparkLib
+  {
+    static char const* Name() { return "mpark::variant"; }
+    template <typename... Ts> using type = mpark::variant<Ts...>;
+    template <typename T, typename V> static T const* GetIf(V const& v) { return mpark::get_if<T>(&v); }
+    template <typename T, typename V, typename A> static void Emplace(V& v, A&& a) { v.template emplace<T>(std::forward<A>(a)); }
+    template <typename F, typename... Vs> static auto Visit(F&& f, Vs&&... vs) -> decltype(mpark::visit(std::forward<F>(f), std::forward<Vs>(vs)...))
+    {
+      return mpark::visit(std::forward<F>(f), std::forward<Vs>(vs)...);
+    }
+  };
+#endif
+
+  // ***** alternative sets *****
+
+  struct Big
+  {
+    size_t m_Key;
+    char   m_Payload[248];
+    explicit Big(size_t key = 0) : m_Key{ key }, m_Payload{} {}
+    bool operator<(Big const& rhs) const { return m_Key < rhs.m_Key; }
+    bool operator==(Big const& rhs) const { return m_Key == rhs.m_Key; }
+  };
+
+  // every set lists its alternatives for library L, First and Second build the alternatives emplace alternates between
+  struct TrivialSet
+  {
+    static char const* Name() { return "trivial"; }
+    static constexpr bool s_Hashable{ true };
+    template <typename L> using type = typename L::template type<int, float, double>;
+    template <typename V> static V Make(size_t i)
+    {
+      switch (i % 3)
+      {
+      case 0:  return V{ static_cast<int>(i) };
+      case 1:  return V{ static_cast<float>(i) };
+      default: return V{ static_cast<double>(i) };
+      }
+    }
+    using first_type = int;
+    using second_type = double;
+    static int First(size_t i) { return static_cast<int>(i); }
+    static double Second(size_t i) { return static_cast<double>(i); }
+  };
+
+  struct StringSet
+  {
+    static char const* Name() { return "string"; }
+    static constexpr bool s_Hashable{ false }; // no std::hash<std::vector<int>>
+    template <typename L> using type = typename L::template type<std::string, int, std::vector<int>>;
+    template <typename V> static V Make(size_t i)
+    {
+      switch (i % 3)
+      {
+      case 0:  return V{ std::string(24 + i % 16, static_cast<char>('a' + i % 26)) }; // beyond small string buffer
+      case 1:  return V{ static_cast<int>(i) };
+      default: return V{ std::vector<int>(i % 8, static_cast<int>(i)) };
+      }
+    }
+    using first_type = std::string;
+    using second_type = int;
+    static std::string First(size_t i) { return std::string(24 + i % 16, 'x'); }
+    static int Second(size_t i) { return static_cast<int>(i); }
+  };
+
+  struct LargeSet
+  {
+    static char const* Name() { return "large"; }
+    static constexpr bool s_Hashable{ false };
+    template <typename L> using type = typename L::template type<int, Big>;
+    template <typename V> static V Make(size_t i)
+    {
+      return i % 4 ? V{ static_cast<int>(i) } : V{ Big{ i } }; // a quarter big
+    }
+    using first_type = int;
+    using second_type = Big;
+    static int First(size_t i) { return static_cast<int>(i); }
+    static Big Second(size_t i) { return Big{ i }; }
+  };
+
+  // ***** visitors *****
+
+  struct Hasher
+  {
+    size_t operator()(Big const& b) const { return std::hash<size_t>{}(b.m_Key); }
+    size_t operator()(std::vector<int> const& v) const { return v.size(); }
+    template <typename T>
+    size_t operator()(T const& t) const { return std::hash<T>{}(t); }
+  };
+
+  struct Sizer
+  {
+    size_t operator()(std::string const& s) const { return s.size(); }
+    size_t operator()(std::vector<int> const& v) const { return v.size(); }
+    size_t operator()(Big const& b) const { return b.m_Key; }
+    template <typename T>
+    size_t operator()(T const& t) const { return static_cast<size_t>(t); }
+  };
+
+  // payload order of two variants already known to hold the same index
+  struct Less
+  {
+    template <typename T>
+    bool operator()(T const& lhs, T const& rhs) const { return lhs < rhs; }
+    template <typename T, typename U>
+    bool operator()(T const&, U const&) const { return false; }
+  };
+
+  // ***** kernels *****
+
+  template <typename L, typename S, typename V = typename S::template type<L>>
+  OWS_BENCH_NOINLINE void KernelConstruct(size_t n)
+  {
+    for (size_t i{ 0 }; i < n; ++i)
+    {
+      V v{ S::template Make<V>(i) };
+      DoNotOptimize(v);
+    }
+  }
+
+  template <typename L, typename S, typename V = typename S::template type<L>>
+  OWS_BENCH_NOINLINE void KernelEmplace(V& v, size_t n)
+  {
+    for (size_t i{ 0 }; i < n; ++i)
+    {
+      if (i & 1)L::template Emplace<typename S::second_type>(v, S::Second(i));
+      else L::template Emplace<typename S::first_type>(v, S::First(i));
+      DoNotOptimize(v);
+    }
+  }
+
+  template <typename L, typename S, typename V = typename S::template type<L>>
+  OWS_BENCH_NOINLINE void KernelCopy(std::vector<V> const& src)
+  {
+    std::vector<V> dst{ src };
+    DoNotOptimize(dst.data());
+  }
+
+  // moves every element across and back via swap, contents survive the round trip
+  template <typename L, typename S, typename V = typename S::template type<L>>
+  OWS_BENCH_NOINLINE void KernelMove(std::vector<V>& src, std::vector<V>& dst)
+  {
+    std::move(src.begin(), src.end(), dst.begin());
+    src.swap(dst);
+    DoNotOptimize(src.data());
+  }
+
+  template <typename L, typename S, typename V = typename S::template type<L>>
+  OWS_BENCH_NOINLINE size_t KernelVisit(std::vector<V> const& src)
+  {
+    size_t sum{ 0 };
+    for (V const& v : src)sum += L::Visit(Sizer{}, v);
+    return sum;
+  }
+
+  template <typename L, typename S, typename V = typename S::template type<L>>
+  OWS_BENCH_NOINLINE size_t KernelGetIf(std::vector<V> const& src)
+  {
+    size_t count{ 0 };
+    for (V const& v : src)count += nullptr != L::template GetIf<typename S::first_type>(v);
+    return count;
+  }
+
+  template <typename L, typename S, typename V = typename S::template type<L>>
+  OWS_BENCH_NOINLINE void KernelSort(std::vector<V>& data)
+  {
+    std::sort(data.begin(), data.end(), [](V const& lhs, V const& rhs)
+    {
+      return lhs.index() != rhs.index() ? lhs.index() < rhs.index() : L::Visit(Less{}, lhs, rhs);
+    });
+    DoNotOptimize(data.data());
+  }
+
+  // the library's own relational operators
+  template <typename L, typename S, typename V = typename S::template type<L>>
+  OWS_BENCH_NOINLINE size_t KernelSortUnique(std::vector<V>& data)
+  {
+    std::sort(data.begin(), data.end());
+    return static_cast<size_t>(std::unique(data.begin(), data.end()) - data.begin());
+  }
+
+  template <typename L, typename S, typename V = typename S::template type<L>>
+  OWS_BENCH_NOINLINE size_t KernelHash(std::vector<V> const& src)
+  {
+    size_t seed{ 0 };
+    for (V const& v : src)seed ^= L::Visit(Hasher{}, v) + 0x9e3779b97f4a7c15ull + (seed << 6) + (seed >> 2);
+    return seed;
+  }
+
+  // the library's std::hash specialization
+  template <typename L, typename S, typename V = typename S::template type<L>>
+  OWS_BENCH_NOINLINE size_t KernelStdHash(std::vector<V> const& src)
+  {
+    size_t sum{ 0 };
+    for (V const& v : src)sum += std::hash<V>{}(v);
+    return sum;
+  }
+
+  template <typename V>
+  OWS_BENCH_NOINLINE size_t KernelHashBytes(std::vector<V> const& src)
+  {
+    size_t sum{ 0 };
+    for (V const& v : src)sum += OWS::hash_bytes(v);
+    return sum;
+  }
+
+  // ***** report *****
+
+  void Report(char const* set, char const* lib, size_t size, char const* kernel, double ns)
+  {
+    std::printf("%-8s %-16s %6zu  %-10s %10.2f\n", set, lib, size, kernel, ns);
+  }
+
+  template <typename L, typename S, typename V>
+  void RunStdHash(std::vector<V> const&, std::false_type /* alternatives not hashable */) {}
+
+  template <typename L, typename S, typename V>
+  void RunStdHash(std::vector<V> const& data, std::true_type)
+  {
+    Report(S::Name(), L::Name(), sizeof(V), "std::hash", Measure([&]{ DoNotOptimize(KernelStdHash<L, S>(data)); }));
+  }
+
+  // hash_bytes is OWS only, for trivially copyable sets
+  template <typename L, typename S, typename V>
+  void RunHashBytes(std::vector<V> const&, std::false_type) {}
+
+  template <typename L, typename S, typename V>
+  void RunHashBytes(std::vector<V> const& data, std::true_type)
+  {
+    Report(S::Name(), L::Name(), sizeof(V), "hash_bytes", Measure([&]{ DoNotOptimize(KernelHashBytes(data)); }));
+  }
+
+  template <typename L, typename S>
+  void Run()
+  {
+    using V = typename S::template type<L>;
+    std::vector<V> data;
+    data.reserve(s_Elements);
+    for (size_t i{ 0 }; i < s_Elements; ++i)data.push_back(S::template Make<V>(i * 2654435761u % s_Elements));// shuffled order
+    std::vector<V> scratch{ data };
+    V single{ S::template Make<V>(0) };
+
+    Report(S::Name(), L::Name(), sizeof(V), "construct", Measure([&]{ KernelConstruct<L, S>(s_Elements); }));
+    Report(S::Name(), L::Name(), sizeof(V), "emplace", Measure([&]{ KernelEmplace<L, S>(single, s_Elements); }));
+    Report(S::Name(), L::Name(), sizeof(V), "copy", Measure([&]{ KernelCopy<L, S>(data); }));
+    Report(S::Name(), L::Name(), sizeof(V), "move", Measure([&]{ KernelMove<L, S>(data, scratch); }));
+    Report(S::Name(), L::Name(), sizeof(V), "visit", Measure([&]{ DoNotOptimize(KernelVisit<L, S>(data)); }));
+    Report(S::Name(), L::Name(), sizeof(V), "get_if", Measure([&]{ DoNotOptimize(KernelGetIf<L, S>(data)); }));
+    Report(S::Name(), L::Name(), sizeof(V), "hash", Measure([&]{ DoNotOptimize(KernelHash<L, S>(data)); }));
+    RunStdHash<L, S>(data, std::integral_constant<bool, S::s_Hashable>{});
+    RunHashBytes<L, S>(data, std::integral_constant<bool, std::is_same<L, OwsLib>::value && std::is_trivially_copyable<V>::value>{});
+    Report(S::Name(), L::Name(), sizeof(V), "sort", Measure([&]{ scratch = data; KernelSort<L, S>(scratch); }));
+    Report(S::Name(), L::Name(), sizeof(V), "sort+uniq", Measure([&]{ scratch = data; DoNotOptimize(KernelSortUnique<L, S>(scratch)); }));
+  }
+
+  template <typename S>
+  void RunSet()
+  {
+    Run<OwsLib, S>();
+#if OWS_BENCH_STD
+    Run<StdLib, S>();
+#endif
+#if OWS_BENCH_VARIANT2
+    Run<Variant2Lib, S>();
+#endif
+#if OWS_BENCH_MPARK
+    Run<MparkLib, S>();
+#endif
+  }
+}
+
+int main()
+{
+  std::printf("%-8s %-16s %6s  %-10s %10s\n", "set", "library", "sizeof", "benchmark", "ns/elem");
+  RunSet<TrivialSet>();
+  RunSet<StringSet>();
+  RunSet<LargeSet>();
+  return 0;
+}
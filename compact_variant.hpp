@@ -0,0 +1,181 @@
+/*!*****************************************************************************
+ * @file    compact_variant.hpp
+ * @author  Owen Huang Wensong
+ * @date    14 OCT 2026
+ * @brief   Variant storing its discriminant in spare payload bits for C++11.
+ *
+ * @par     Copyright (c) 2023 Owen Huang Wensong.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+*******************************************************************************/
+
+#ifndef HEADER_GUARD_OWS_COMPACT_VARIANT_HPP
+#define HEADER_GUARD_OWS_COMPACT_VARIANT_HPP
+
+#include "variant.hpp"
+
+namespace OWS
+{
+  // Niche description of an alternative, specialize for user types.
+  // s_SpareBits low bits of encode(value) must be 0, decode receives them cleared.
+  template <typename T, typename = void>
+  struct compact_traits;
+
+  namespace detail
+  {
+    namespace cvrnt
+    {
+      constexpr unsigned Log2(size_t n) { return n < 2 ? 0 : 1 + Log2(n / 2); }
+
+      // bits needed to tell N alternatives apart
+      constexpr unsigned TagBits(size_t n) { return n < 2 ? 0 : 1 + Log2(n - 1); }
+    }
+  }
+
+  // pointers spare their alignment bits
+  template <typename T>
+  struct compact_traits<T*, typename std::enable_if<!std::is_void<T>::value && !std::is_function<T>::value>::type>
+  {
+    static constexpr unsigned s_SpareBits{ detail::cvrnt::Log2(alignof(T)) };
+    static std::uintptr_t encode(T* ptr) noexcept { return reinterpret_cast<std::uintptr_t>(ptr); }
+    static T* decode(std::uintptr_t bits) noexcept { return reinterpret_cast<T*>(bits); }
+  };
+
+  template <typename... Ts>
+  class CompactVariant;
+
+  namespace detail
+  {
+    namespace cvrnt
+    {
+      template <typename R, typename F, typename... Ts>
+      struct VisitOp
+      {
+        using Fn = typename std::remove_reference<F>::type;
+        using result_type = R;
+        using fnptr_type = R (*)(std::uintptr_t, Fn*);
+        static constexpr size_t s_Count{ sizeof...(Ts) };
+
+        template <size_t I, typename T = typename vrnt::IthType<I, Ts...>::type>
+        static R call(std::uintptr_t payload, Fn* f) { return std::forward<F>(*f)(compact_traits<T>::decode(payload)); }
+      };
+    }
+  }
+
+  // Discriminant kept in the low bits every alternative leaves spare, so CompactVariant<A*, B*, C*> is one pointer.
+  // Alternatives are held by value, there is no valueless state, default construction holds alternative 0 decoded from 0.
+  template <typename... Ts>
+  class CompactVariant
+  {
+  public:
+
+    static_assert(true == detail::vrnt::is_unique<Ts...>::value, "compact variant should have unique parameter list");
+    static_assert(detail::vrnt::CTMM<unsigned, compact_traits<Ts>::s_SpareBits...>::s_min >= detail::cvrnt::TagBits(sizeof...(Ts)),
+      "compact variant alternatives do not spare enough low bits for the index, see OWS::compact_traits");
+
+    static constexpr unsigned s_TagBits{ detail::cvrnt::TagBits(sizeof...(Ts)) };
+    static constexpr std::uintptr_t s_TagMask{ (std::uintptr_t{ 1 } << s_TagBits) - 1 };
+
+    CompactVariant() = default;
+
+    template <typename T, typename U = typename std::enable_if<detail::vrnt::is_any<typename detail::vrnt::remove_cvref<T>::type, Ts...>::value, T>::type>
+    explicit CompactVariant(T&& value) noexcept : m_Bits{ Encode<typename detail::vrnt::remove_cvref<U>::type>(value) } {}
+
+    template <typename T, typename U = typename std::enable_if<detail::vrnt::is_any<typename detail::vrnt::remove_cvref<T>::type, Ts...>::value, T>::type>
+    CompactVariant& operator=(T&& value) noexcept
+    {
+      m_Bits = Encode<typename detail::vrnt::remove_cvref<U>::type>(value);
+      return *this;
+    }
+
+    unsigned index() const noexcept { return static_cast<unsigned>(m_Bits & s_TagMask); }
+    bool valueless() const noexcept { return false; }
+
+    template <typename T>
+    bool holds_alternative() const noexcept { return detail::vrnt::IFromType<0, T, Ts...>::value == index(); }
+
+    // pointer alternatives only, the held pointer or nullptr when another alternative is held
+    template <typename T>
+    typename std::enable_if<detail::vrnt::is_any<T, Ts...>::value && std::is_pointer<T>::value, T>::type get_if() const noexcept
+    {
+      return holds_alternative<T>() ? Decode<T>() : nullptr;
+    }
+
+    template <typename T>
+    typename std::enable_if<detail::vrnt::is_any<T, Ts...>::value, T>::type get() const
+    {
+      if (!holds_alternative<T>())detail::vrnt::BadAccess(static_cast<unsigned>(detail::vrnt::IFromType<0, T, Ts...>::value), index());
+      return Decode<T>();
+    }
+
+    template <size_t I, typename T = typename std::enable_if<I < sizeof...(Ts), typename detail::vrnt::IthType<I, Ts...>::type>::type>
+    T get() const
+    {
+      return get<T>();
+    }
+
+    template <typename T>
+    typename std::enable_if<detail::vrnt::is_any<T, Ts...>::value, T>::type emplace(T value) noexcept
+    {
+      m_Bits = Encode<T>(value);
+      return value;
+    }
+
+    template <size_t I, typename T = typename std::enable_if<I < sizeof...(Ts), typename detail::vrnt::IthType<I, Ts...>::type>::type>
+    T emplace(T value) noexcept
+    {
+      return emplace<T>(value);
+    }
+
+    // payload with the index bits cleared, as passed to compact_traits::decode
+    std::uintptr_t payload() const noexcept { return m_Bits & ~s_TagMask; }
+    std::uintptr_t bits() const noexcept { return m_Bits; }
+
+  private:
+
+    template <typename T>
+    static std::uintptr_t Encode(T const& value) noexcept
+    {
+      return compact_traits<T>::encode(value) | detail::vrnt::IFromType<0, T, Ts...>::value;
+    }
+
+    template <typename T>
+    T Decode() const noexcept { return compact_traits<T>::decode(payload()); }
+
+    std::uintptr_t m_Bits{ 0 };
+  };
+
+  // single dispatch on the index bits, f receives the decoded alternative by value
+  template <typename F, typename... Ts>
+  inline auto visit(F&& f, CompactVariant<Ts...> const& v)
+    -> typename detail::vrnt::CommonResult<decltype(std::declval<F>()(std::declval<Ts>()))...>::type
+  {
+    using R = typename detail::vrnt::CommonResult<decltype(std::declval<F>()(std::declval<Ts>()))...>::type;
+    return detail::vrnt::Dispatch<detail::cvrnt::VisitOp<R, F, Ts...>>(v.index(), v.payload(), &f);
+  }
+
+#if OWS_SMOKE_TEST
+  static_assert(sizeof(void*) == sizeof(OWS::CompactVariant<int*, double*, long long*>),                   "compact variant: size failure");
+  static_assert(true == std::is_trivially_copyable<OWS::CompactVariant<int*, double*>>::value,            "compact variant: trivial copy failure");
+  static_assert(2 == OWS::CompactVariant<int*, double*, long long*>::s_TagBits,                           "compact variant: tag bits failure");
+  static_assert(2 == OWS::compact_traits<int*>::s_SpareBits,                                               "compact variant: pointer niche failure");
+#endif // OWS_SMOKE_TEST
+}
+
+#endif // !HEADER_GUARD_OWS_COMPACT_VARIANT_HPP
@@ -0,0 +1,299 @@
+/*!*****************************************************************************
+ * @file    inline_any.hpp
+ * @author  Owen Huang Wensong
+ * @date    14 OCT 2026
+ * @brief   Small buffer type erased value for C++11.
+ *
+ * @par     Copyright (c) 2023 Owen Huang Wensong.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+*******************************************************************************/
+
+#ifndef HEADER_GUARD_OWS_INLINE_ANY_HPP
+#define HEADER_GUARD_OWS_INLINE_ANY_HPP
+
+#include "variant.hpp"
+
+namespace OWS
+{
+  // ***************************************************************************
+  // *************************************************************** detail ****
+
+  namespace detail
+  {
+    namespace iany
+    {
+      // One table per held type, its address doubles as the type's identity so no RTTI is involved.
+      // nullptr entries are trivial, relocation is then a copy of the buffer and destruction does nothing.
+      struct VTable
+      {
+        void (*m_Destroy)(void* buffer) noexcept;
+        void (*m_Copy)(void* to, void const* from);
+        void (*m_Relocate)(void* to, void* from) noexcept; // leaves from without a value
+        bool m_Inline;
+      };
+
+      // T lives in the buffer when it fits and cannot throw on move, otherwise the buffer holds a T*
+      template <typename T, size_t Capacity, size_t Align>
+      struct Fits : public std::integral_constant<bool,
+        sizeof(T) <= Capacity && alignof(T) <= Align && 0 == Align % alignof(T) && std::is_nothrow_move_constructible<T>::value>{};
+
+      template <typename T, bool Inline>
+      struct Ops
+      {
+        static T* Get(void* buffer) noexcept { return static_cast<T*>(buffer); }
+        static void Destroy(void* buffer) noexcept { Get(buffer)->~T(); }
+        static void Copy(void* to, void const* from) { ::new (to) T(*static_cast<T const*>(from)); }
+        static void Relocate(void* to, void* from) noexcept
+        {
+          ::new (to) T(std::move(*Get(from)));
+          Destroy(from);
+        }
+
+        static constexpr bool s_Trivial{ std::is_trivially_copyable<T>::value && std::is_trivially_destructible<T>::value };
+        static constexpr VTable s_Table{ std::is_trivially_destructible<T>::value ? nullptr : &Destroy, &Copy, s_Trivial ? nullptr : &Relocate, true };
+      };
+
+      template <typename T>
+      struct Ops<T, false>
+      {
+        static T* Get(void* buffer) noexcept { return *static_cast<T**>(buffer); }
+        static void Destroy(void* buffer) noexcept { delete Get(buffer); }
+        static void Copy(void* to, void const* from) { *static_cast<T**>(to) = new T(**static_cast<T* const*>(from)); }
+
+        // relocating the pointer is a buffer copy
+        static constexpr VTable s_Table{ &Destroy, &Copy, nullptr, false };
+      };
+
+      // linkage for pre C++17 struct static inline constexpr
+      template <typename T, bool Inline>
+      constexpr VTable Ops<T, Inline>::s_Table;
+
+      template <typename T>
+      constexpr VTable Ops<T, false>::s_Table;
+    }
+  }
+
+  // *************************************************************** detail ****
+  // ***************************************************************************
+
+  // Type erased value kept in a Capacity byte buffer aligned to Align, one table pointer beside it.
+  // Types that do not fit, or may throw on move, go to the heap when Spill and are rejected at compile time otherwise.
+  // Held types are copy constructible. Type identity is the address of a per type table, which shared libraries
+  // built without vague linkage merging (e.g. Windows DLLs) do not share, values crossing such a boundary fail any_cast.
+  template <size_t Capacity = 4 * sizeof(void*), size_t Align = alignof(std::max_align_t), bool Spill = true>
+  class InlineAny
+  {
+    template <typename T>
+    using Decay = typename std::decay<T>::type;
+
+    template <typename T>
+    using OpsOf = detail::iany::Ops<T, detail::iany::Fits<T, Capacity, Align>::value>;
+
+    template <typename T>
+    using IsValue = std::integral_constant<bool, !std::is_same<Decay<T>, InlineAny>::value && std::is_copy_constructible<Decay<T>>::value>;
+
+  public:
+
+    static_assert(Capacity >= sizeof(void*) && Align >= alignof(void*), "inline any buffer should hold a pointer");
+
+    static constexpr size_t s_Capacity{ Capacity };
+
+    // whether T is held in the buffer
+    template <typename T>
+    using stores_inline = detail::iany::Fits<T, Capacity, Align>;
+
+    InlineAny() noexcept = default;
+
+    InlineAny(InlineAny const& other) : m_VTable{ nullptr }
+    {
+      if (other.m_VTable)
+      {
+        other.m_VTable->m_Copy(m_Buffer, other.m_Buffer);
+        m_VTable = other.m_VTable;
+      }
+    }
+
+    InlineAny(InlineAny&& other) noexcept : m_VTable{ nullptr } { Take(other); }
+
+    template <typename T, typename = typename std::enable_if<IsValue<T>::value>::type>
+    InlineAny(T&& value) : m_VTable{ nullptr }
+    {
+      emplace<Decay<T>>(std::forward<T>(value));
+    }
+
+    ~InlineAny() { reset(); }
+
+    InlineAny& operator=(InlineAny const& rhs)
+    {
+      if (this != &rhs)
+      {
+        InlineAny copy{ rhs }; // a throwing copy leaves this untouched
+        reset();
+        Take(copy);
+      }
+      return *this;
+    }
+
+    InlineAny& operator=(InlineAny&& rhs) noexcept
+    {
+      if (this != &rhs)
+      {
+        reset();
+        Take(rhs);
+      }
+      return *this;
+    }
+
+    // builds the new value first, rhs may be the held value and a throwing constructor leaves this untouched
+    template <typename T, typename = typename std::enable_if<IsValue<T>::value>::type>
+    InlineAny& operator=(T&& rhs)
+    {
+      InlineAny tmp{ std::forward<T>(rhs) };
+      reset();
+      Take(tmp);
+      return *this;
+    }
+
+    // destroys the held value first, a throwing constructor leaves this without a value
+    template <typename T, typename... Args>
+    T& emplace(Args&&... args)
+    {
+      static_assert(std::is_same<Decay<T>, T>::value, "inline any holds decayed types");
+      static_assert(std::is_copy_constructible<T>::value, "inline any holds copy constructible types");
+      static_assert(Spill || stores_inline<T>::value, "inline any type should fit the buffer, be nothrow movable or allow spilling");
+      reset();
+      T* const value{ Construct<T>(stores_inline<T>{}, std::forward<Args>(args)...) };
+      m_VTable = &OpsOf<T>::s_Table;
+      return *value;
+    }
+
+    void reset() noexcept
+    {
+      if (m_VTable && m_VTable->m_Destroy)m_VTable->m_Destroy(m_Buffer);
+      m_VTable = nullptr;
+    }
+
+    void swap(InlineAny& other) noexcept
+    {
+      InlineAny tmp{ std::move(other) };
+      other = std::move(*this);
+      *this = std::move(tmp);
+    }
+
+    bool has_value() const noexcept { return nullptr != m_VTable; }
+
+    // false when empty or the value spilled to the heap
+    bool is_inline() const noexcept { return m_VTable && m_VTable->m_Inline; }
+
+    template <typename T>
+    bool holds() const noexcept { return &OpsOf<T>::s_Table == m_VTable; }
+
+    // one pointer compare, nullptr unless exactly T is held
+    template <typename T>
+    T* get_if() noexcept { return holds<T>() ? OpsOf<T>::Get(m_Buffer) : nullptr; }
+
+    template <typename T>
+    T const* get_if() const noexcept { return holds<T>() ? OpsOf<T>::Get(const_cast<unsigned char*>(m_Buffer)) : nullptr; }
+
+  private:
+
+    template <typename T, typename... Args>
+    T* Construct(std::true_type /* inline */, Args&&... args)
+    {
+      return ::new (static_cast<void*>(m_Buffer)) T(std::forward<Args>(args)...);
+    }
+
+    template <typename T, typename... Args>
+    T* Construct(std::false_type /* spill */, Args&&... args)
+    {
+      T* const value{ new T(std::forward<Args>(args)...) };
+      *reinterpret_cast<T**>(m_Buffer) = value;
+      return value;
+    }
+
+    // this holds no value
+    void Take(InlineAny& other) noexcept
+    {
+      if (nullptr == other.m_VTable)return;
+      if (other.m_VTable->m_Relocate)other.m_VTable->m_Relocate(m_Buffer, other.m_Buffer);
+      else std::memcpy(m_Buffer, other.m_Buffer, Capacity);
+      m_VTable = other.m_VTable;
+      other.m_VTable = nullptr;
+    }
+
+    alignas(Align) unsigned char m_Buffer[Capacity];
+    detail::iany::VTable const* m_VTable{ nullptr };
+  };
+
+  template <size_t C, size_t A, bool S>
+  inline void swap(InlineAny<C, A, S>& lhs, InlineAny<C, A, S>& rhs) noexcept { lhs.swap(rhs); }
+
+  // nullptr when a is nullptr or does not hold exactly T
+  template <typename T, size_t C, size_t A, bool S>
+  inline T* any_cast(InlineAny<C, A, S>* a) noexcept
+  {
+    return a ? a->template get_if<T>() : nullptr;
+  }
+
+  template <typename T, size_t C, size_t A, bool S>
+  inline T const* any_cast(InlineAny<C, A, S> const* a) noexcept
+  {
+    return a ? a->template get_if<T>() : nullptr;
+  }
+
+  // T may be a reference, throws bad_variant_access (or calls the no exceptions handler) when T is not held
+  template <typename T, size_t C, size_t A, bool S>
+  inline T any_cast(InlineAny<C, A, S>& a)
+  {
+    using U = typename detail::vrnt::remove_cvref<T>::type;
+    U* const value{ a.template get_if<U>() };
+    if (nullptr == value)detail::vrnt::BadAccess("any_cast to a type not held");
+    return static_cast<T>(*value);
+  }
+
+  template <typename T, size_t C, size_t A, bool S>
+  inline T any_cast(InlineAny<C, A, S> const& a)
+  {
+    using U = typename detail::vrnt::remove_cvref<T>::type;
+    U const* const value{ a.template get_if<U>() };
+    if (nullptr == value)detail::vrnt::BadAccess("any_cast to a type not held");
+    return static_cast<T>(*value);
+  }
+
+  template <typename T, size_t C, size_t A, bool S>
+  inline T any_cast(InlineAny<C, A, S>&& a)
+  {
+    using U = typename detail::vrnt::remove_cvref<T>::type;
+    U* const value{ a.template get_if<U>() };
+    if (nullptr == value)detail::vrnt::BadAccess("any_cast to a type not held");
+    return static_cast<T>(std::move(*value));
+  }
+
+#if OWS_SMOKE_TEST
+  static_assert(true  == OWS::InlineAny<>::stores_inline<std::string>::value,                 "inline any: buffer failure");
+  static_assert(false == OWS::InlineAny<8>::stores_inline<std::string>::value,                "inline any: spill failure");
+  static_assert(true  == std::is_nothrow_move_constructible<OWS::InlineAny<>>::value,         "inline any: move failure");
+  static_assert(0 == sizeof(OWS::InlineAny<>) % alignof(std::max_align_t),                     "inline any: layout failure");
+  static_assert(true  == OWS::detail::iany::Ops<int, true>::s_Trivial,                        "inline any: relocation failure");
+  static_assert(false == OWS::detail::iany::Ops<std::string, true>::s_Trivial,                "inline any: relocation failure");
+#endif // OWS_SMOKE_TEST
+}
+
+#endif // !HEADER_GUARD_OWS_INLINE_ANY_HPP
@@ -0,0 +1,212 @@
+/*!*****************************************************************************
+ * @file    recursive_variant.hpp
+ * @author  Owen Huang Wensong
+ * @date    14 OCT 2026
+ * @brief   Arena allocated recursive alternatives for C++11.
+ *
+ * @par     Copyright (c) 2023 Owen Huang Wensong.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+*******************************************************************************/
+
+#ifndef HEADER_GUARD_OWS_RECURSIVE_VARIANT_HPP
+#define HEADER_GUARD_OWS_RECURSIVE_VARIANT_HPP
+
+#include "variant.hpp"
+
+namespace OWS
+{
+  // Bump allocator owning large blocks, memory comes back all at once on release or destruction.
+  // Single threaded, a tree built on several threads needs an arena per thread.
+  class Arena
+  {
+  public:
+
+    static constexpr size_t s_DefaultBlock{ size_t{ 1 } << 20 };
+
+    // blocks this large are served by the allocator's mmap path on common C libraries
+    explicit Arena(size_t blockBytes = s_DefaultBlock) noexcept : m_BlockBytes{ blockBytes < 256 ? 256 : blockBytes } {}
+
+    Arena(Arena const&) = delete;
+    Arena& operator=(Arena const&) = delete;
+
+    ~Arena() { release(); }
+
+    void* allocate(size_t bytes, size_t align)
+    {
+      std::uintptr_t const at{ (reinterpret_cast<std::uintptr_t>(m_Cursor) + align - 1) & ~(std::uintptr_t{ align } - 1) };
+      if (nullptr == m_Cursor || at + bytes > reinterpret_cast<std::uintptr_t>(m_End))return Grow(bytes, align);
+      m_Cursor = reinterpret_cast<char*>(at + bytes);
+      return reinterpret_cast<void*>(at);
+    }
+
+    // frees every block, objects still living in the arena must already be destroyed or never be touched again
+    void release() noexcept
+    {
+      while (m_Head)
+      {
+        Block* const next{ m_Head->m_Next };
+        ::operator delete(static_cast<void*>(m_Head));
+        m_Head = next;
+      }
+      m_Cursor = m_End = nullptr;
+      m_Capacity = 0;
+    }
+
+    // bytes held from the system
+    size_t capacity() const noexcept { return m_Capacity; }
+
+  private:
+
+    struct Block
+    {
+      Block* m_Next;
+    };
+
+    OWS_VRNT_COLD void* Grow(size_t bytes, size_t align)
+    {
+      size_t const need{ sizeof(Block) + bytes + align };
+      bool const alone{ need > m_BlockBytes / 4 }; // own block, the current one keeps serving small requests
+      size_t const size{ alone ? need : m_BlockBytes };
+
+      Block* const block{ static_cast<Block*>(::operator new(size)) };
+      m_Capacity += size;
+      if (alone && m_Head)
+      {
+        block->m_Next = m_Head->m_Next;
+        m_Head->m_Next = block;
+      }
+      else
+      {
+        block->m_Next = m_Head;
+        m_Head = block;
+      }
+
+      char* const begin{ reinterpret_cast<char*>(block + 1) };
+      std::uintptr_t const at{ (reinterpret_cast<std::uintptr_t>(begin) + align - 1) & ~(std::uintptr_t{ align } - 1) };
+      if (!alone || nullptr == m_Cursor)
+      {
+        m_Cursor = reinterpret_cast<char*>(at + bytes);
+        m_End = reinterpret_cast<char*>(block) + size;
+      }
+      return reinterpret_cast<void*>(at);
+    }
+
+    Block* m_Head{ nullptr };
+    char* m_Cursor{ nullptr };
+    char* m_End{ nullptr };
+    size_t m_BlockBytes;
+    size_t m_Capacity{ 0 };
+  };
+
+  // ***************************************************************************
+  // *************************************************************** detail ****
+
+  namespace detail
+  {
+    namespace rvrnt
+    {
+      inline Arena*& Current() noexcept
+      {
+        static thread_local Arena* s_Current{ nullptr };
+        return s_Current;
+      }
+
+      [[noreturn]] OWS_VRNT_COLD inline void NoArena()
+      {
+#if OWS_VARIANT_NO_EXCEPTIONS
+        std::abort();
+#else
+        throw std::bad_alloc{};
+#endif
+      }
+    }
+  }
+
+  // *************************************************************** detail ****
+  // ***************************************************************************
+
+  // routes ArenaAllocator allocations on this thread to arena until destroyed, scopes nest
+  class ArenaScope
+  {
+  public:
+
+    explicit ArenaScope(Arena& arena) noexcept : m_Previous{ detail::rvrnt::Current() } { detail::rvrnt::Current() = &arena; }
+
+    ArenaScope(ArenaScope const&) = delete;
+    ArenaScope& operator=(ArenaScope const&) = delete;
+
+    ~ArenaScope() { detail::rvrnt::Current() = m_Previous; }
+
+  private:
+
+    Arena* m_Previous;
+  };
+
+  // Stateless allocator drawing from the innermost ArenaScope's arena, bad_alloc outside any scope.
+  // deallocate is a no-op, so it also suits containers inside a tree, e.g. std::vector<Node, ArenaAllocator<Node>>.
+  template <typename T>
+  class ArenaAllocator
+  {
+  public:
+
+    using value_type = T;
+
+    ArenaAllocator() = default;
+    template <typename U>
+    ArenaAllocator(ArenaAllocator<U> const&) noexcept {}
+
+    T* allocate(size_t count)
+    {
+      Arena* const arena{ detail::rvrnt::Current() };
+      if (nullptr == arena)detail::rvrnt::NoArena();
+      return static_cast<T*>(arena->allocate(count * sizeof(T), alignof(T)));
+    }
+
+    void deallocate(T*, size_t) noexcept {}
+
+    template <typename U>
+    bool operator==(ArenaAllocator<U> const&) const noexcept { return true; }
+    template <typename U>
+    bool operator!=(ArenaAllocator<U> const&) const noexcept { return false; }
+  };
+
+  // Indirect alternative for recursive variants, T may be incomplete where the variant is declared.
+  // get, get_if, holds_alternative, emplace and visit see T. Nodes are built under an ArenaScope and destroyed
+  // before their arena is released, destruction runs ~T but frees nothing node by node.
+  template <typename T>
+  using Recursive = Boxed<T, ArenaAllocator<T>>;
+
+#if OWS_SMOKE_TEST
+  namespace detail
+  {
+    namespace rvrnt
+    {
+      struct SmokeNode;
+      using SmokeValue = OWS::Variant<double, OWS::Recursive<SmokeNode>>;
+      struct SmokeNode { SmokeValue m_Value; };
+    }
+  }
+
+  static_assert(sizeof(void*) == sizeof(OWS::Recursive<OWS::detail::rvrnt::SmokeNode>), "recursive variant: indirection failure");
+  static_assert(true == std::is_same<OWS::detail::rvrnt::SmokeNode*, decltype(std::declval<OWS::detail::rvrnt::SmokeValue&>().get_if<OWS::detail::rvrnt::SmokeNode>())>::value, "recursive variant: transparent access failure");
+#endif // OWS_SMOKE_TEST
+}
+
+#endif // !HEADER_GUARD_OWS_RECURSIVE_VARIANT_HPP
@@ -0,0 +1,166 @@
+/*!*****************************************************************************
+ * @file    seq_variant.hpp
+ * @author  Owen Huang Wensong
+ * @date    14 OCT 2026
+ * @brief   Single writer, lock free reader variant snapshots for C++11.
+ *
+ * @par     Copyright (c) 2023 Owen Huang Wensong.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+*******************************************************************************/
+
+#ifndef HEADER_GUARD_OWS_SEQ_VARIANT_HPP
+#define HEADER_GUARD_OWS_SEQ_VARIANT_HPP
+
+#include "variant.hpp"
+
+#include <atomic> // sequence counters, payload words
+#include <cstring>// memcpy
+
+namespace OWS
+{
+  // ***************************************************************************
+  // *************************************************************** detail ****
+
+  namespace detail
+  {
+    namespace svrnt
+    {
+      using word_type = std::uintptr_t;
+
+      // one buffer of the double buffer, odd sequence while the writer is inside
+      // payload words are relaxed atomics so torn reads are detected rather than racy
+      template <size_t N>
+      struct alignas(64) Slot
+      {
+        std::atomic<word_type> m_Seq{ 0 };
+        std::atomic<word_type> m_Words[N];
+      };
+
+      template <typename V>
+      struct Words : public std::integral_constant<size_t, (sizeof(V) + sizeof(word_type) - 1) / sizeof(word_type)>{};
+
+      // V viewed as whole words, the tail past sizeof(V) stays zero
+      template <typename V>
+      union Image
+      {
+        Image() noexcept : m_Words{} {}
+
+        word_type m_Words[Words<V>::value];
+        typename std::aligned_storage<sizeof(V), alignof(V)>::type m_Value;
+      };
+    }
+  }
+
+  // *************************************************************** detail ****
+  // ***************************************************************************
+
+  // Double buffered seqlock over a variant of trivially copyable alternatives, for payloads too large for AtomicVariant.
+  // One writer publishes each value into the buffer readers are not on, readers copy a snapshot without locking and
+  // retry only when the writer laps them, i.e. finished two publishes during a single copy.
+  template <typename... Ts>
+  class SeqVariant
+  {
+  public:
+
+    using value_type = Variant<Ts...>;
+
+    static_assert(true == std::is_trivially_copyable<value_type>::value, "seq variant alternatives should be trivially copyable");
+
+    // valueless
+    SeqVariant() noexcept { Publish(value_type{}); }
+
+    explicit SeqVariant(value_type const& variant) noexcept { Publish(variant); }
+
+    SeqVariant(SeqVariant const&) = delete;
+    SeqVariant& operator=(SeqVariant const&) = delete;
+
+    // writer only, the value is built before any buffer is touched so construction cost never reaches readers
+    template <typename T, typename... Args>
+    typename std::enable_if<detail::vrnt::is_any<T, Ts...>::value>::type emplace(Args&&... args)
+    {
+      value_type staged;
+      staged.template emplace<T>(std::forward<Args>(args)...);
+      Publish(staged);
+    }
+
+    // writer only
+    void store(value_type const& variant) noexcept { Publish(variant); }
+
+    // consistent copy of the latest published value, never blocks
+    value_type load() const noexcept
+    {
+      detail::svrnt::Image<value_type> image;
+      for (;;)
+      {
+        Slot const& slot{ m_Slots[m_Active.load(std::memory_order_acquire)] };
+        detail::svrnt::word_type const seq{ slot.m_Seq.load(std::memory_order_acquire) };
+        if (seq & 1)continue; // writer lapped onto this buffer
+
+        for (size_t i{ 0 }; i < s_Words; ++i)image.m_Words[i] = slot.m_Words[i].load(std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (seq == slot.m_Seq.load(std::memory_order_relaxed))break;
+      }
+
+      value_type snapshot;
+      std::memcpy(static_cast<void*>(&snapshot), &image.m_Value, sizeof(value_type));
+      return snapshot;
+    }
+
+    // f visits a consistent snapshot, it runs exactly once and never on a torn value
+    template <typename F>
+    auto read(F&& f) const -> decltype(visit(std::forward<F>(f), std::declval<value_type const&>()))
+    {
+      value_type const snapshot{ load() };
+      return visit(std::forward<F>(f), snapshot);
+    }
+
+  private:
+
+    static constexpr size_t s_Words{ detail::svrnt::Words<value_type>::value };
+    using Slot = detail::svrnt::Slot<s_Words>;
+
+    void Publish(value_type const& variant) noexcept
+    {
+      detail::svrnt::Image<value_type> image;
+      std::memcpy(&image.m_Value, static_cast<void const*>(&variant), sizeof(value_type));
+
+      unsigned const next{ 1u - m_Active.load(std::memory_order_relaxed) };
+      Slot& slot{ m_Slots[next] };
+      detail::svrnt::word_type const seq{ slot.m_Seq.load(std::memory_order_relaxed) };
+
+      slot.m_Seq.store(seq + 1, std::memory_order_relaxed);
+      std::atomic_thread_fence(std::memory_order_release);
+      for (size_t i{ 0 }; i < s_Words; ++i)slot.m_Words[i].store(image.m_Words[i], std::memory_order_relaxed);
+      slot.m_Seq.store(seq + 2, std::memory_order_release);
+      m_Active.store(next, std::memory_order_release);
+    }
+
+    Slot m_Slots[2];
+    std::atomic<unsigned> m_Active{ 0 };
+  };
+
+#if OWS_SMOKE_TEST
+  static_assert(2 == OWS::detail::svrnt::Words<char[2 * sizeof(std::uintptr_t)]>::value,     "seq variant: word count failure");
+  static_assert(3 == OWS::detail::svrnt::Words<char[2 * sizeof(std::uintptr_t) + 1]>::value, "seq variant: word count failure");
+  static_assert(64 == alignof(OWS::SeqVariant<int, double>),                                  "seq variant: buffer alignment failure");
+#endif // OWS_SMOKE_TEST
+}
+
+#endif // !HEADER_GUARD_OWS_SEQ_VARIANT_HPP
@@ -0,0 +1,552 @@
+/*!*****************************************************************************
+ * @file    tagged_array.hpp
+ * @author  Owen Huang Wensong
+ * @date    14 OCT 2026
+ * @brief   Structure of arrays variant container with SIMD tag scanning for C++11.
+ *
+ * @par     Copyright (c) 2023 Owen Huang Wensong.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+*******************************************************************************/
+
+#ifndef HEADER_GUARD_OWS_TAGGED_ARRAY_HPP
+#define HEADER_GUARD_OWS_TAGGED_ARRAY_HPP
+
+#include "variant.hpp"
+
+#include <vector> // tag column
+#include <memory> // unique_ptr payload column
+#include <cstring>// memcpy
+
+// Tag scanning instruction set, 0 scalar, 1 SSE2, 2 AVX2, 3 NEON. Detected from the target unless defined.
+#ifndef OWS_TAGGED_ARRAY_SIMD
+#if defined(__AVX2__)
+#define OWS_TAGGED_ARRAY_SIMD 2
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define OWS_TAGGED_ARRAY_SIMD 1
+#elif defined(__ARM_NEON) || defined(__aarch64__) || defined(_M_ARM64)
+#define OWS_TAGGED_ARRAY_SIMD 3
+#else
+#define OWS_TAGGED_ARRAY_SIMD 0
+#endif
+#endif
+
+#if 1 == OWS_TAGGED_ARRAY_SIMD
+#include <emmintrin.h>
+#elif 2 == OWS_TAGGED_ARRAY_SIMD
+#include <immintrin.h>
+#elif 3 == OWS_TAGGED_ARRAY_SIMD
+#include <arm_neon.h>
+#endif
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+
+namespace OWS
+{
+  // ***************************************************************************
+  // *************************************************************** detail ****
+
+  namespace detail
+  {
+    namespace tarr
+    {
+      // ***** tag scanning *****
+      // MatchBlock compares s_Block tags at once, each matching lane sets s_LaneBits bits of the mask.
+
+#if 1 == OWS_TAGGED_ARRAY_SIMD
+      static constexpr size_t s_Block{ 16 };
+      static constexpr unsigned s_LaneBits{ 1 };
+
+      inline std::uint64_t MatchBlock(std::uint8_t const* tags, std::uint8_t tag) noexcept
+      {
+        __m128i const eq{ _mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<__m128i const*>(tags)), _mm_set1_epi8(static_cast<char>(tag))) };
+        return static_cast<std::uint32_t>(_mm_movemask_epi8(eq));
+      }
+#elif 2 == OWS_TAGGED_ARRAY_SIMD
+      static constexpr size_t s_Block{ 32 };
+      static constexpr unsigned s_LaneBits{ 1 };
+
+      inline std::uint64_t MatchBlock(std::uint8_t const* tags, std::uint8_t tag) noexcept
+      {
+        __m256i const eq{ _mm256_cmpeq_epi8(_mm256_loadu_si256(reinterpret_cast<__m256i const*>(tags)), _mm256_set1_epi8(static_cast<char>(tag))) };
+        return static_cast<std::uint32_t>(_mm256_movemask_epi8(eq));
+      }
+#elif 3 == OWS_TAGGED_ARRAY_SIMD
+      static constexpr size_t s_Block{ 16 };
+      static constexpr unsigned s_LaneBits{ 4 };
+
+      // narrowing shift packs the 16 byte compare into 4 bits per lane, NEON has no movemask
+      inline std::uint64_t MatchBlock(std::uint8_t const* tags, std::uint8_t tag) noexcept
+      {
+        uint8x16_t const eq{ vceqq_u8(vld1q_u8(tags), vdupq_n_u8(tag)) };
+        return vget_lane_u64(vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(eq), 4)), 0);
+      }
+#else
+      static constexpr size_t s_Block{ 0 };
+      static constexpr unsigned s_LaneBits{ 1 };
+
+      inline std::uint64_t MatchBlock(std::uint8_t const*, std::uint8_t) noexcept { return 0; }
+#endif
+
+      inline unsigned PopCount(std::uint64_t mask) noexcept
+      {
+#if defined(__GNUC__) || defined(__clang__)
+        return static_cast<unsigned>(__builtin_popcountll(mask));
+#else
+        mask = mask - ((mask >> 1) & 0x5555555555555555ull);
+        mask = (mask & 0x3333333333333333ull) + ((mask >> 2) & 0x3333333333333333ull);
+        return static_cast<unsigned>((((mask + (mask >> 4)) & 0x0F0F0F0F0F0F0F0Full) * 0x0101010101010101ull) >> 56);
+#endif
+      }
+
+      // mask must not be 0
+      inline unsigned TrailingZeros(std::uint64_t mask) noexcept
+      {
+#if defined(__GNUC__) || defined(__clang__)
+        return static_cast<unsigned>(__builtin_ctzll(mask));
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_ARM64))
+        unsigned long bit;
+        _BitScanForward64(&bit, mask);
+        return static_cast<unsigned>(bit);
+#else
+        unsigned bit{ 0 };
+        while (!(mask & 1))mask >>= 1, ++bit;
+        return bit;
+#endif
+      }
+
+      // SIMD scanning only applies to byte tags, wider index types scan scalar
+      template <typename IndexType>
+      struct Scanner
+      {
+        static size_t Count(IndexType const* tags, size_t n, IndexType tag) noexcept
+        {
+          size_t count{ 0 };
+          for (size_t i{ 0 }; i < n; ++i)count += tag == tags[i];
+          return count;
+        }
+
+        static size_t Find(IndexType const* tags, size_t i, size_t n, IndexType tag) noexcept
+        {
+          for (; i < n; ++i)if (tag == tags[i])return i;
+          return n;
+        }
+
+        static void Collect(IndexType const* tags, size_t n, IndexType tag, std::vector<size_t>& out)
+        {
+          for (size_t i{ 0 }; i < n; ++i)if (tag == tags[i])out.push_back(i);
+        }
+      };
+
+      template <>
+      struct Scanner<std::uint8_t>
+      {
+        static size_t Count(std::uint8_t const* tags, size_t n, std::uint8_t tag) noexcept
+        {
+          size_t count{ 0 }, i{ 0 };
+          for (; s_Block && i + s_Block <= n; i += s_Block)count += PopCount(MatchBlock(tags + i, tag)) / s_LaneBits;
+          for (; i < n; ++i)count += tag == tags[i];
+          return count;
+        }
+
+        static size_t Find(std::uint8_t const* tags, size_t i, size_t n, std::uint8_t tag) noexcept
+        {
+          for (; s_Block && i + s_Block <= n; i += s_Block)
+          {
+            std::uint64_t const mask{ MatchBlock(tags + i, tag) };
+            if (mask)return i + TrailingZeros(mask) / s_LaneBits;
+          }
+          for (; i < n; ++i)if (tag == tags[i])return i;
+          return n;
+        }
+
+        static void Collect(std::uint8_t const* tags, size_t n, std::uint8_t tag, std::vector<size_t>& out)
+        {
+          size_t i{ 0 };
+          for (; s_Block && i + s_Block <= n; i += s_Block)
+          {
+            for (std::uint64_t mask{ MatchBlock(tags + i, tag) }; mask;)
+            {
+              unsigned const lane{ TrailingZeros(mask) / s_LaneBits };
+              out.push_back(i + lane);
+              mask &= ~(((std::uint64_t{ 1 } << s_LaneBits) - 1) << (lane * s_LaneBits));
+            }
+          }
+          for (; i < n; ++i)if (tag == tags[i])out.push_back(i);
+        }
+      };
+
+      // ***** payload slots *****
+
+      // slots are aligned by hand, array new ignores over alignment before C++17
+      template <typename Slot>
+      struct FreeSlots
+      {
+        void operator()(Slot* slots) const noexcept { vrnt::AlignedFree<alignof(Slot)>(slots); }
+      };
+
+      template <typename... Ts>
+      struct SlotOps
+      {
+        using Slot = vrnt::RawStorage<Ts...>;
+        using Slots = std::unique_ptr<Slot[], FreeSlots<Slot>>;
+
+        static Slots Allocate(size_t count) { return Slots{ static_cast<Slot*>(vrnt::AlignedAllocate<alignof(Slot)>(count * sizeof(Slot))) }; }
+
+        template <typename T>
+        static T& Ref(Slot& slot) noexcept { return reinterpret_cast<T&>(slot.m_Raw); }
+
+        template <typename T>
+        static T const& Ref(Slot const& slot) noexcept { return reinterpret_cast<T const&>(slot.m_Raw); }
+
+        struct DestroyOp
+        {
+          using result_type = void;
+          using fnptr_type = void (*)(Slot*);
+          static constexpr size_t s_Count{ sizeof...(Ts) };
+
+          template <size_t I, typename T = typename vrnt::IthType<I, Ts...>::type>
+          static void call(Slot* slot) noexcept { Ref<T>(*slot).~T(); }
+        };
+
+        struct CopyOp
+        {
+          using result_type = void;
+          using fnptr_type = void (*)(Slot*, Slot const*);
+          static constexpr size_t s_Count{ sizeof...(Ts) };
+
+          template <size_t I, typename T = typename vrnt::IthType<I, Ts...>::type>
+          static void call(Slot* dst, Slot const* src) { vrnt::Construct<T>(dst->m_Raw, Ref<T>(*src)); }
+        };
+
+        // move construct into dst and destroy src
+        struct RelocateOp
+        {
+          using result_type = void;
+          using fnptr_type = void (*)(Slot*, Slot*);
+          static constexpr size_t s_Count{ sizeof...(Ts) };
+
+          template <size_t I, typename T = typename vrnt::IthType<I, Ts...>::type>
+          static void call(Slot* dst, Slot* src) noexcept(std::is_nothrow_move_constructible<T>::value)
+          {
+            vrnt::Construct<T>(dst->m_Raw, std::move(Ref<T>(*src)));
+            Ref<T>(*src).~T();
+          }
+        };
+
+        template <typename R, typename F, typename S>
+        struct VisitOp
+        {
+          using Fn = typename std::remove_reference<F>::type;
+          using result_type = R;
+          using fnptr_type = R (*)(S*, Fn*);
+          static constexpr size_t s_Count{ sizeof...(Ts) };
+
+          template <size_t I, typename T = typename vrnt::IthType<I, Ts...>::type>
+          static R call(S* slot, Fn* f) { return std::forward<F>(*f)(Ref<T>(*slot)); }
+        };
+      };
+    }
+  }
+
+  // *************************************************************** detail ****
+  // ***************************************************************************
+
+  // Variant elements split into a dense tag column and a parallel payload column laid out like Variant's m_Raw.
+  // Tag queries only touch the tag column, scanned with SSE2, AVX2 or NEON when tags are bytes.
+  template <typename... Ts>
+  class TaggedArray
+  {
+    using Ops = detail::tarr::SlotOps<Ts...>;
+    using Slot = typename Ops::Slot;
+
+  public:
+
+    static_assert(true == detail::vrnt::is_unique<Ts...>::value, "tagged array should have unique parameter list");
+
+    using index_type = typename detail::vrnt::IndexType<sizeof...(Ts)>::type;
+    using variant_type = Variant<Ts...>;
+
+    TaggedArray() = default;
+
+    TaggedArray(TaggedArray const& other) : TaggedArray{}
+    {
+      reserve(other.size());
+      for (size_t i{ 0 }, count{ other.size() }; i < count; ++i)
+      {
+        detail::vrnt::Dispatch<typename Ops::CopyOp>(other.m_Tags[i], &m_Slots[i], &other.m_Slots[i]);
+        m_Tags.push_back(other.m_Tags[i]);// capacity reserved, cannot throw
+      }
+    }
+
+    TaggedArray(TaggedArray&& other) noexcept : m_Tags{ std::move(other.m_Tags) }, m_Slots{ std::move(other.m_Slots) }, m_Capacity{ other.m_Capacity }
+    {
+      other.m_Tags.clear();
+      other.m_Capacity = 0;
+    }
+
+    TaggedArray& operator=(TaggedArray const& other)
+    {
+      if (this != &other)*this = TaggedArray{ other };
+      return *this;
+    }
+
+    TaggedArray& operator=(TaggedArray&& other) noexcept
+    {
+      if (this == &other)return *this;
+      clear();
+      m_Tags = std::move(other.m_Tags);
+      m_Slots = std::move(other.m_Slots);
+      m_Capacity = other.m_Capacity;
+      other.m_Tags.clear();
+      other.m_Capacity = 0;
+      return *this;
+    }
+
+    ~TaggedArray() { clear(); }
+
+    size_t size() const noexcept { return m_Tags.size(); }
+    size_t capacity() const noexcept { return m_Capacity; }
+    bool empty() const noexcept { return m_Tags.empty(); }
+
+    // dense tag column, one index per element
+    index_type const* tags() const noexcept { return m_Tags.data(); }
+    unsigned index(size_t i) const noexcept { return m_Tags[i]; }
+
+    // parallel payload column, size() slots of detail::vrnt::RawStorage<Ts...>
+    void const* payload() const noexcept { return m_Slots.get(); }
+
+    void reserve(size_t count)
+    {
+      if (count <= m_Capacity)return;
+      m_Tags.reserve(count);// first, push_back then never reallocates
+      typename Ops::Slots slots{ Ops::Allocate(count) };
+      Relocate(slots.get(), m_Slots.get(), size());
+      m_Slots = std::move(slots);
+      m_Capacity = count;
+    }
+
+    void clear() noexcept
+    {
+      for (size_t i{ 0 }, count{ size() }; i < count; ++i)Destroy(i);
+      m_Tags.clear();
+    }
+
+    void pop_back() noexcept
+    {
+      Destroy(size() - 1);
+      m_Tags.pop_back();
+    }
+
+    template <typename T, typename... Args>
+    typename std::enable_if<detail::vrnt::is_any<T, Ts...>::value, T>::type& emplace_back(Args&&... args)
+    {
+      if (size() == m_Capacity)return GrowEmplace<T>(std::forward<Args>(args)...);
+      T* item{ detail::vrnt::Construct<T>(m_Slots[size()].m_Raw, std::forward<Args>(args)...) };
+      m_Tags.push_back(static_cast<index_type>(detail::vrnt::IFromType<0, T, Ts...>::value));// capacity reserved, cannot throw
+      return *item;
+    }
+
+    template <typename T, typename U = typename std::enable_if<detail::vrnt::is_any<typename detail::vrnt::remove_cvref<T>::type, Ts...>::value, T>::type>
+    void push_back(T&& value)
+    {
+      emplace_back<typename detail::vrnt::remove_cvref<U>::type>(std::forward<U>(value));
+    }
+
+    // appends the held alternative, single dispatch
+    void push_back(variant_type const& variant) { visit(Pusher{ this }, variant); }
+    void push_back(variant_type&& variant) { visit(Pusher{ this }, std::move(variant)); }
+
+    template <typename T>
+    bool holds_alternative(size_t i) const noexcept { return detail::vrnt::IFromType<0, T, Ts...>::value == m_Tags[i]; }
+
+    template <typename T>
+    typename std::enable_if<detail::vrnt::is_any<T, Ts...>::value, T*>::type get_if(size_t i) noexcept
+    {
+      return holds_alternative<T>(i) ? &Ops::template Ref<T>(m_Slots[i]) : nullptr;
+    }
+
+    template <typename T>
+    typename std::enable_if<detail::vrnt::is_any<T, Ts...>::value, T const*>::type get_if(size_t i) const noexcept
+    {
+      return holds_alternative<T>(i) ? &Ops::template Ref<T>(m_Slots[i]) : nullptr;
+    }
+
+    template <typename T>
+    typename std::enable_if<detail::vrnt::is_any<T, Ts...>::value, T&>::type get(size_t i)
+    {
+      if (!holds_alternative<T>(i))detail::vrnt::BadAccess(static_cast<unsigned>(detail::vrnt::IFromType<0, T, Ts...>::value), index(i));
+      return Ops::template Ref<T>(m_Slots[i]);
+    }
+
+    template <typename T>
+    typename std::enable_if<detail::vrnt::is_any<T, Ts...>::value, T const&>::type get(size_t i) const
+    {
+      if (!holds_alternative<T>(i))detail::vrnt::BadAccess(static_cast<unsigned>(detail::vrnt::IFromType<0, T, Ts...>::value), index(i));
+      return Ops::template Ref<T>(m_Slots[i]);
+    }
+
+    // f on the ith element, single dispatch
+    template <typename F>
+    auto visit_at(size_t i, F&& f) -> typename detail::vrnt::CommonResult<decltype(f(std::declval<Ts&>()))...>::type
+    {
+      using R = typename detail::vrnt::CommonResult<decltype(f(std::declval<Ts&>()))...>::type;
+      return detail::vrnt::Dispatch<typename Ops::template VisitOp<R, F, Slot>>(m_Tags[i], &m_Slots[i], &f);
+    }
+
+    template <typename F>
+    auto visit_at(size_t i, F&& f) const -> typename detail::vrnt::CommonResult<decltype(f(std::declval<Ts const&>()))...>::type
+    {
+      using R = typename detail::vrnt::CommonResult<decltype(f(std::declval<Ts const&>()))...>::type;
+      return detail::vrnt::Dispatch<typename Ops::template VisitOp<R, F, Slot const>>(m_Tags[i], &m_Slots[i], &f);
+    }
+
+    // ***** tag scans, the payload column is never loaded *****
+
+    template <typename T>
+    size_t count() const noexcept
+    {
+      return Scanner::Count(m_Tags.data(), size(), Tag<T>());
+    }
+
+    // position of the first element holding T at or after from, size() if none
+    template <typename T>
+    size_t find_first(size_t from = 0) const noexcept
+    {
+      return Scanner::Find(m_Tags.data(), from, size(), Tag<T>());
+    }
+
+    // appends the position of every element holding T to out
+    template <typename T>
+    void indices_of(std::vector<size_t>& out) const
+    {
+      Scanner::Collect(m_Tags.data(), size(), Tag<T>(), out);
+    }
+
+    template <typename T>
+    std::vector<size_t> indices_of() const
+    {
+      std::vector<size_t> out;
+      indices_of<T>(out);
+      return out;
+    }
+
+  private:
+
+    using Scanner = detail::tarr::Scanner<index_type>;
+
+    template <typename T>
+    static constexpr index_type Tag() noexcept { return static_cast<index_type>(detail::vrnt::IFromType<0, T, Ts...>::value); }
+
+    struct Pusher
+    {
+      TaggedArray* m_Self;
+      template <typename T>
+      void operator()(T&& value) const { m_Self->push_back(std::forward<T>(value)); }
+    };
+
+    // args may refer to elements, so the new one is built in the new slots before the old ones are relocated and freed
+    template <typename T, typename... Args>
+    OWS_VRNT_COLD T& GrowEmplace(Args&&... args)
+    {
+      size_t const count{ m_Capacity ? 2 * m_Capacity : 16 };
+      m_Tags.reserve(count);// first, push_back then never reallocates
+      typename Ops::Slots slots{ Ops::Allocate(count) };
+      T* const item{ detail::vrnt::Construct<T>(slots[size()].m_Raw, std::forward<Args>(args)...) };
+
+      struct Guard
+      {
+        T* m_Item;
+        ~Guard() { if (m_Item)m_Item->~T(); }
+      } built{ item };
+      Relocate(slots.get(), m_Slots.get(), size());
+      built.m_Item = nullptr;
+
+      m_Slots = std::move(slots);
+      m_Capacity = count;
+      m_Tags.push_back(Tag<T>());// capacity reserved, cannot throw
+      return *item;
+    }
+
+    void Destroy(size_t i) noexcept
+    {
+      detail::vrnt::Dispatch<typename Ops::DestroyOp>(m_Tags[i], &m_Slots[i]);
+    }
+
+    // like std::vector, elements move when none can throw doing so (or some cannot be copied), otherwise they are copied
+    using MovesSafely = std::integral_constant<bool, detail::vrnt::all_of<std::is_nothrow_move_constructible, Ts...>::value ||
+      !detail::vrnt::all_of<std::is_copy_constructible, Ts...>::value>;
+
+    // destroys the copies made so far unless the whole range was copied
+    struct CopyGuard
+    {
+      Slot* m_Dst;
+      index_type const* m_Tags;
+      size_t m_Count;
+
+      ~CopyGuard()
+      {
+        while (m_Count--)detail::vrnt::Dispatch<typename Ops::DestroyOp>(m_Tags[m_Count], &m_Dst[m_Count]);
+      }
+    };
+
+    // a throw leaves src untouched and dst without elements
+    void Relocate(Slot* dst, Slot* src, size_t count) noexcept(detail::vrnt::all_of<is_trivially_relocatable, Ts...>::value || MovesSafely::value)
+    {
+      Relocate(std::integral_constant<bool, detail::vrnt::all_of<is_trivially_relocatable, Ts...>::value>{}, dst, src, count);
+    }
+
+    void Relocate(std::true_type /* relocatable */, Slot* dst, Slot* src, size_t count) noexcept
+    {
+      if (count)std::memcpy(dst, src, count * sizeof(Slot));
+    }
+
+    void Relocate(std::false_type /* per element */, Slot* dst, Slot* src, size_t count) noexcept(MovesSafely::value)
+    {
+      RelocateAs(MovesSafely{}, dst, src, count);
+    }
+
+    void RelocateAs(std::true_type /* move */, Slot* dst, Slot* src, size_t count) noexcept(MovesSafely::value)
+    {
+      for (size_t i{ 0 }; i < count; ++i)detail::vrnt::Dispatch<typename Ops::RelocateOp>(m_Tags[i], &dst[i], &src[i]);
+    }
+
+    void RelocateAs(std::false_type /* copy */, Slot* dst, Slot* src, size_t count)
+    {
+      CopyGuard copied{ dst, m_Tags.data(), 0 };
+      for (; copied.m_Count < count; ++copied.m_Count)
+        detail::vrnt::Dispatch<typename Ops::CopyOp>(m_Tags[copied.m_Count], &dst[copied.m_Count], &src[copied.m_Count]);
+      copied.m_Count = 0;
+      for (size_t i{ 0 }; i < count; ++i)detail::vrnt::Dispatch<typename Ops::DestroyOp>(m_Tags[i], &src[i]);
+    }
+
+    std::vector<index_type> m_Tags;  // one index per element, capacity kept at least m_Capacity
+    typename Ops::Slots m_Slots;     // first size() slots hold the alternative named by the tag
+    size_t m_Capacity{ 0 };
+  };
+
+#if OWS_SMOKE_TEST
+  static_assert(true == std::is_same<std::uint8_t const*, decltype(std::declval<OWS::TaggedArray<int, float>&>().tags())>::value, "tagged array: byte tag failure");
+  static_assert(sizeof(OWS::detail::vrnt::RawStorage<char, double>) == sizeof(double),                                                   "tagged array: payload layout failure");
+#endif // OWS_SMOKE_TEST
+}
+
+#endif // !HEADER_GUARD_OWS_TAGGED_ARRAY_HPP
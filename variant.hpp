@@ -31,15 +31,125 @@
 // Some of these may be included in each other.
 // However some nested includes are implementation dependent,
 // so include headers which guarantee inclusion of dependencies.
-#include <string> // exception str
+#include <string> // std::string smoke tests
 #include <limits> // numeric_limits
 #include <cstddef>// size_t
-#include <utility>// std::forward
+#include <cstdlib>// std::abort
+#include <new>    // placement new, operator new
+#include <cstdint>// uint8_t, uint16_t, uint32_t
+#include <cstring>// memcpy
+#include <utility>// std::forward, std::swap
+#include <initializer_list>
 #include <exception>  // std::exception
-#include <type_traits>// is_same, integral_constant, remove_reference, remove_cv
+#include <functional> // std::hash
+#include <type_traits>// is_same, integral_constant, remove_reference, remove_cv, common_type
+
+#if defined(_MSC_VER)
+#define OWS_VRNT_UNREACHABLE() __assume(0)
+#elif defined(__GNUC__) || defined(__clang__)
+#define OWS_VRNT_UNREACHABLE() __builtin_unreachable()
+#else
+#define OWS_VRNT_UNREACHABLE() static_cast<void>(0)
+#endif
+
+#if defined(__GNUC__) || defined(__clang__)
+#define OWS_VRNT_LIKELY(x) __builtin_expect(!!(x), 1)
+#else
+#define OWS_VRNT_LIKELY(x) (x)
+#endif
+
+#if defined(_MSC_VER)
+#define OWS_VRNT_COLD __declspec(noinline)
+#elif defined(__GNUC__) || defined(__clang__)
+#define OWS_VRNT_COLD __attribute__((noinline, cold))
+#else
+#define OWS_VRNT_COLD
+#endif
+
+// Exception free mode, failed get and visit call the bad_variant_access_handler then abort instead of throwing.
+// Defaults on when the compiler has exceptions disabled.
+#ifndef OWS_VARIANT_NO_EXCEPTIONS
+#if defined(__cpp_exceptions) || defined(__EXCEPTIONS) || defined(_CPPUNWIND)
+#define OWS_VARIANT_NO_EXCEPTIONS 0
+#else
+#define OWS_VARIANT_NO_EXCEPTIONS 1
+#endif
+#endif
+
+// Alternative count up to which dispatch expands into an inlinable switch chain instead of a function pointer table.
+#ifndef OWS_VARIANT_SWITCH_MAX
+#define OWS_VARIANT_SWITCH_MAX 8
+#endif
+
+// Opt-in auto boxing, alternatives larger than this many bytes are stored as OWS::Boxed. 0 disables.
+#ifndef OWS_VARIANT_BOX_THRESHOLD
+#define OWS_VARIANT_BOX_THRESHOLD 0
+#endif
+
+// Alternative count up to which literal alternatives use constexpr union storage instead of raw bytes. 0 always uses raw bytes.
+#ifndef OWS_VARIANT_CONSTEXPR_MAX
+#define OWS_VARIANT_CONSTEXPR_MAX 32
+#endif
+
+// Opt-in layout policy, drops alternative alignment so arrays of variants pack the tag against the payload.
+// Only honoured on targets with hardware unaligned access, alternatives are then accessed unaligned.
+#ifndef OWS_VARIANT_PACKED_TAG
+#define OWS_VARIANT_PACKED_TAG 0
+#endif
+
+// Opt-in exception policy, emplace and assignment build an alternative whose constructor may throw aside first, so a
+// throw keeps the held alternative. Alternatives should then be nothrow move constructible, Boxed otherwise.
+// Off, such a throw leaves the variant valueless. Default constructed variants are valueless under either policy.
+#ifndef OWS_VARIANT_NEVER_VALUELESS
+#define OWS_VARIANT_NEVER_VALUELESS 0
+#endif
+
+// Opt-in counters per Variant instantiation, see OWS::variant_stats. Off compiles every hook out.
+#ifndef OWS_VARIANT_STATS
+#define OWS_VARIANT_STATS 0
+#endif
+
+#if OWS_VARIANT_STATS
+#include <atomic>// counters
+#include <mutex> // thread registry
+#define OWS_VRNT_STAT(...) __VA_ARGS__
+#define OWS_VRNT_STATS_CONSTEXPR // counting constructors cannot be constexpr
+#else
+#define OWS_VRNT_STAT(...)
+#define OWS_VRNT_STATS_CONSTEXPR constexpr
+#endif
 
 namespace OWS
 {
+  template <typename... Ts>
+  class Variant;
+
+  namespace detail
+  {
+    namespace vrnt
+    {
+      template <typename T>
+      struct InPlaceType{};
+
+      template <size_t I>
+      struct InPlaceIndex{};
+    }
+  }
+
+  // In place construction tags usable as values without C++14 variable templates, OWS::in_place_type<T> names a
+  // function and decays to in_place_type_t<T>, e.g. Variant<int, Msg> v{ OWS::in_place_type<Msg>, id, payload }.
+  template <typename T>
+  using in_place_type_t = void (*)(detail::vrnt::InPlaceType<T>);
+
+  template <size_t I>
+  using in_place_index_t = void (*)(detail::vrnt::InPlaceIndex<I>);
+
+  template <typename T>
+  inline void in_place_type(detail::vrnt::InPlaceType<T>) noexcept {}
+
+  template <size_t I>
+  inline void in_place_index(detail::vrnt::InPlaceIndex<I>) noexcept {}
+
   // ***************************************************************************
   // *************************************************************** detail ****
 
@@ -47,57 +157,208 @@ namespace OWS
   {
     namespace vrnt
     {
+      template <typename T>
+      struct type_identity{ using type = T; };
+
+      // Metafunctions below keep O(log N) instantiation depth and close to O(N) instantiations,
+      // variants with hundreds of alternatives stay within compiler template depth limits.
+
+      // pre C++14 index_sequence
+      template <size_t... Is>
+      struct index_sequence{};
+
+      template <typename A, typename B>
+      struct concat_sequence;
+
+      template <size_t... As, size_t... Bs>
+      struct concat_sequence<index_sequence<As...>, index_sequence<Bs...>>{ using type = index_sequence<As..., (sizeof...(As) + Bs)...>; };
+
+      // binary split, depth log2(N)
+      template <size_t N>
+      struct make_index_sequence : public concat_sequence<typename make_index_sequence<N / 2>::type, typename make_index_sequence<N - N / 2>::type>{};
+
+      template <> // template specialization floor
+      struct make_index_sequence<0>{ using type = index_sequence<>; };
+
+      template <> // template specialization floor
+      struct make_index_sequence<1>{ using type = index_sequence<0>; };
+
+      template <typename T, T... Vs>
+      struct CTValues{ static constexpr T s_Values[]{ Vs... }; };
+
+      // linkage for pre C++17 struct static inline constexpr
+      template <typename T, T... Vs>
+      constexpr T CTValues<T, Vs...>::s_Values[];
+
+      template <typename T>
+      constexpr T CTMin(T a, T b) { return a > b ? b : a; }
+
+      template <typename T>
+      constexpr T CTMax(T a, T b) { return a > b ? a : b; }
+
+      // binary split over [p, p + n), depth log2(n)
+      template <typename T>
+      constexpr T CTMinOf(T const* p, size_t n) { return 1 == n ? p[0] : CTMin(CTMinOf(p, n / 2), CTMinOf(p + n / 2, n - n / 2)); }
+
+      template <typename T>
+      constexpr T CTMaxOf(T const* p, size_t n) { return 1 == n ? p[0] : CTMax(CTMaxOf(p, n / 2), CTMaxOf(p + n / 2, n - n / 2)); }
+
       // Compile Time Min Max
-      template <typename T, T A, T B, T... Cs>
+      template <typename T, T A, T... Cs>
       struct CTMM
       {
-        static constexpr T s_min{ CTMM<T, CTMM<T, A, B>::s_min, Cs...>::s_min };
-        static constexpr T s_max{ CTMM<T, CTMM<T, A, B>::s_max, Cs...>::s_max };
+        static constexpr T s_min{ CTMinOf(CTValues<T, A, Cs...>::s_Values, 1 + sizeof...(Cs)) };
+        static constexpr T s_max{ CTMaxOf(CTValues<T, A, Cs...>::s_Values, 1 + sizeof...(Cs)) };
       };
 
-      // Compile Time Min Max
-      template <typename T, T A, T B>
-      struct CTMM<T, A, B>
-      {
-        static constexpr T s_min{ A > B ? B : A };
-        static constexpr T s_max{ A > B ? A : B };
-      };
+      // single instantiation conjunction of bool constants
+      template <bool... Bs>
+      struct bool_pack{};
+
+      template <bool... Bs>
+      struct all_true : public std::is_same<bool_pack<true, Bs...>, bool_pack<Bs..., true>>{};
 
       // pre C++17 disjunction
       template <typename R, typename T, typename... Ts>
-      struct is_any : public std::integral_constant<bool, std::is_same<R, T>::value || is_any<R, Ts...>::value>{};
-
-      template <typename R, typename T> // template specialization floor
-      struct is_any<R, T> : public std::is_same<R, T>{};
+      struct is_any : public std::integral_constant<bool, !all_true<!std::is_same<R, T>::value, !std::is_same<R, Ts>::value...>::value>{};
 
       // pre C++17 conjunction
       template <typename R, typename T, typename... Ts>
-      struct is_all : public std::integral_constant<bool, std::is_same<R, T>::value && is_all<R, Ts...>::value>{};
+      struct is_all : public all_true<std::is_same<R, T>::value, std::is_same<R, Ts>::value...>{};
 
-      template <typename R, typename T> // template specialization floor
-      struct is_all<R, T> : public std::is_same<R, T>{};
+      // every type of a pack as a distinct base, looked up by overload resolution instead of recursion
+      template <size_t I, typename T>
+      struct IndexedLeaf : public type_identity<T>{};
 
-      // no duplicate types in parameter pack
-      template <typename T, typename... Ts>
-      struct is_unique : public std::integral_constant<bool, !is_any<T, Ts...>::value && is_unique<Ts...>::value>{};
+      template <typename Seq, typename... Ts>
+      struct IndexedImpl;
 
-      template <typename T> // template specialization floor
-      struct is_unique<T> : public std::integral_constant<bool, true>{};
+      template <size_t... Is, typename... Ts>
+      struct IndexedImpl<index_sequence<Is...>, Ts...> : public IndexedLeaf<Is, Ts>...{};
 
-      template <size_t I, typename T, typename... Ts>
-      struct IthType{ using type = typename IthType<I - 1, Ts...>::type; };
+      template <typename... Ts>
+      struct Indexed : public IndexedImpl<typename make_index_sequence<sizeof...(Ts)>::type, Ts...>{};
 
-      template <typename T, typename... Ts> // template specialization floor
-      struct IthType<0, T, Ts...>{ using type = T; };
+      // declarations only, called qualified so ADL never instantiates the pack's types
+      template <size_t I, typename T> // deduces T for I
+      type_identity<T> IndexedAt(IndexedLeaf<I, T> const*);
 
-      template <size_t I, typename R, typename T, typename... Ts>
-      struct IFromType : public std::integral_constant<typename std::enable_if<is_any<R, T, Ts...>::value, size_t>::type, IFromType<I + 1, R, Ts...>::value>{};
+      template <typename T, size_t I> // deduces I for T
+      std::integral_constant<size_t, I> IndexedOf(IndexedLeaf<I, T> const*);
+
+      // no duplicate types in parameter pack, a duplicate makes its type_identity base ambiguous
+      template <typename T, typename... Ts>
+      struct is_unique : public all_true<std::is_convertible<Indexed<T, Ts...>*, type_identity<T>*>::value, std::is_convertible<Indexed<T, Ts...>*, type_identity<Ts>*>::value...>{};
+
+      template <size_t I, typename T, typename... Ts>
+      struct IthType : public decltype(vrnt::IndexedAt<I>(static_cast<Indexed<T, Ts...>*>(nullptr))){};
 
-      template <size_t I, typename R, typename... Ts>
-      struct IFromType<I, R, R, Ts...> : public std::integral_constant<size_t, I>{};
+      template <size_t I, typename R, typename T, typename... Ts>
+      struct IFromType : public std::integral_constant<typename std::enable_if<is_any<R, T, Ts...>::value, size_t>::type,
+        I + decltype(vrnt::IndexedOf<R>(static_cast<Indexed<T, Ts...>*>(nullptr)))::value>{};
 
       template <typename T>
       struct remove_cvref : public std::remove_cv<typename std::remove_reference<T>::type> {};
+
+      // smallest unsigned type holding indices 0 to N - 1 and the valueless sentinel, the type's maximum
+      template <size_t N>
+      struct IndexType : public std::conditional<(N <= UINT8_MAX), std::uint8_t,
+        typename std::conditional<(N <= UINT16_MAX), std::uint16_t, std::uint32_t>::type>{};
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86) || defined(__aarch64__) || defined(_M_ARM64)
+      static constexpr bool s_UnalignedAccess{ true };
+#else
+      static constexpr bool s_UnalignedAccess{ false };
+#endif
+
+      // alternative payload bytes, the layout of Variant's m_Raw without the index
+      template <typename... Ts>
+      struct RawSize : public std::integral_constant<size_t, CTMM<size_t, sizeof(Ts)...>::s_max>{};
+
+      template <typename... Ts>
+      struct alignas(CTMM<size_t, alignof(Ts)...>::s_max) RawStorage{ char m_Raw[RawSize<Ts...>::value]; };
+
+      // variant alignment, alternatives and index unless the packed tag policy applies
+      template <typename... Ts>
+      struct VariantAlign : public std::integral_constant<size_t, (OWS_VARIANT_PACKED_TAG && s_UnalignedAccess) ?
+        alignof(typename IndexType<sizeof...(Ts)>::type) :
+        CTMM<size_t, alignof(Ts)..., alignof(typename IndexType<sizeof...(Ts)>::type)>::s_max>{};
+
+      // alternative reference type carrying the constness and value category of variant reference V
+      template <typename V, typename T>
+      struct copy_cvref{ using type = T&&; };
+
+      template <typename V, typename T>
+      struct copy_cvref<V&, T>{ using type = T&; };
+
+      template <typename V, typename T>
+      struct copy_cvref<V const&, T>{ using type = T const&; };
+
+      template <typename V, typename T>
+      struct copy_cvref<V const&&, T>{ using type = T const&&; };
+
+      template <typename T>
+      struct is_variant : public std::false_type{};
+
+      template <typename... Ts>
+      struct is_variant<Variant<Ts...>> : public std::true_type{};
+
+      // alternatives are built with parentheses as std::variant does, so vector(3, 1) is three ones,
+      // braces only for aggregates without a matching constructor before C++20's parenthesized aggregate init
+      template <typename T, typename... Args>
+      struct ParenInit : public std::is_constructible<T, Args...>{};
+
+      template <typename T, typename... Args>
+      inline T* ConstructAs(std::true_type /* parentheses */, void* at, Args&&... args)
+      {
+        return ::new (at) T(std::forward<Args>(args)...);
+      }
+
+      template <typename T, typename... Args>
+      inline T* ConstructAs(std::false_type /* braces */, void* at, Args&&... args)
+      {
+        return ::new (at) T{ std::forward<Args>(args)... };
+      }
+
+      template <typename T, typename... Args>
+      inline T* Construct(void* at, Args&&... args)
+      {
+        return ConstructAs<T>(ParenInit<T, Args...>{}, at, std::forward<Args>(args)...);
+      }
+
+      // ::operator new, and array new before C++17, only guarantee alignof(std::max_align_t), larger alignments
+      // are made by hand with the pointer new returned kept just before the aligned block
+      template <size_t Align>
+      using OverAligned = std::integral_constant<bool, (Align > alignof(std::max_align_t))>;
+
+      inline void* AlignedAllocateAs(std::false_type /* aligned by new */, size_t bytes, size_t) { return ::operator new(bytes); }
+      inline void AlignedFreeAs(std::false_type /* aligned by new */, void* ptr) noexcept { ::operator delete(ptr); }
+
+      inline void* AlignedAllocateAs(std::true_type /* over aligned */, size_t bytes, size_t align)
+      {
+        void* const raw{ ::operator new(bytes + sizeof(void*) + align) };
+        std::uintptr_t const at{ (reinterpret_cast<std::uintptr_t>(raw) + sizeof(void*) + align - 1) & ~(std::uintptr_t{ align } - 1) };
+        reinterpret_cast<void**>(at)[-1] = raw;
+        return reinterpret_cast<void*>(at);
+      }
+
+      inline void AlignedFreeAs(std::true_type /* over aligned */, void* ptr) noexcept { ::operator delete(static_cast<void**>(ptr)[-1]); }
+
+      template <size_t Align>
+      inline void* AlignedAllocate(size_t bytes) { return AlignedAllocateAs(OverAligned<Align>{}, bytes, Align); }
+
+      template <size_t Align>
+      inline void AlignedFree(void* ptr) noexcept { AlignedFreeAs(OverAligned<Align>{}, ptr); }
+
+      // unchecked access to variant storage, befriended by Variant
+      struct Access;
+
+      // alternative of from moved or copied into to by remapped index, false when to has no such alternative, see convert section
+      template <typename To, typename From>
+      bool Convert(To& to, From&& from);
+
+      template <typename From, typename To>
+      struct is_subset;
     }
   }
 
@@ -106,6 +367,7 @@ namespace OWS
   static_assert(6  == OWS::detail::vrnt::CTMM<int, -5, 3, 6, 1, 5>::s_max, "detail: CTMM logic failure");
   static_assert(1  == OWS::detail::vrnt::CTMM<size_t,  3, 6, 1, 5>::s_min, "detail: CTMM logic failure");
   static_assert(6  == OWS::detail::vrnt::CTMM<size_t,  3, 6, 1, 5>::s_max, "detail: CTMM logic failure");
+  static_assert(7  == OWS::detail::vrnt::CTMM<size_t,  7>::s_max,          "detail: CTMM logic failure");
 
   static_assert(true  == OWS::detail::vrnt::is_any<bool, char, int, float, bool>::value,  "detail: is_any compile time logic failure");
   static_assert(false == OWS::detail::vrnt::is_any<bool, char, int, float>::value,        "detail: is_any compile time logic failure");
@@ -118,6 +380,8 @@ namespace OWS
   static_assert(false == OWS::detail::vrnt::is_unique<bool, float, int, float, double>::value,  "detail: is_unique compile time logic failure");
   static_assert(true  == OWS::detail::vrnt::is_unique<bool, char, int, float, double>::value,   "detail: is_unique compile time logic failure");
   static_assert(true  == OWS::detail::vrnt::is_unique<bool, char, int, float, double>::value,   "detail: is_unique compile time logic failure");
+  static_assert(false == OWS::detail::vrnt::is_unique<bool, char, int, float, int>::value,      "detail: is_unique compile time logic failure");
+  static_assert(true  == OWS::detail::vrnt::is_unique<bool>::value,                             "detail: is_unique compile time logic failure");
 
   static_assert(true  == std::is_same<bool, typename OWS::detail::vrnt::IthType<0, bool, char, int>::type>::value, "detail: IthType compile time logic failure");
   static_assert(true  == std::is_same<char, typename OWS::detail::vrnt::IthType<1, bool, char, int>::type>::value, "detail: IthType compile time logic failure");
@@ -129,6 +393,15 @@ namespace OWS
   static_assert(false == std::is_same<int,  typename OWS::detail::vrnt::IthType<0, bool, char, int>::type>::value, "detail: IthType compile time logic failure");
   static_assert(false == std::is_same<int,  typename OWS::detail::vrnt::IthType<1, bool, char, int>::type>::value, "detail: IthType compile time logic failure");
 
+  static_assert(true  == std::is_same<OWS::detail::vrnt::index_sequence<>,           typename OWS::detail::vrnt::make_index_sequence<0>::type>::value, "detail: make_index_sequence compile time logic failure");
+  static_assert(true  == std::is_same<OWS::detail::vrnt::index_sequence<0, 1, 2, 3, 4>, typename OWS::detail::vrnt::make_index_sequence<5>::type>::value, "detail: make_index_sequence compile time logic failure");
+
+  static_assert(true  == std::is_same<std::uint8_t,  typename OWS::detail::vrnt::IndexType<1>::type>::value,     "detail: IndexType compile time logic failure");
+  static_assert(true  == std::is_same<std::uint8_t,  typename OWS::detail::vrnt::IndexType<255>::type>::value,   "detail: IndexType compile time logic failure");
+  static_assert(true  == std::is_same<std::uint16_t, typename OWS::detail::vrnt::IndexType<256>::type>::value,   "detail: IndexType compile time logic failure");
+  static_assert(true  == std::is_same<std::uint16_t, typename OWS::detail::vrnt::IndexType<65535>::type>::value, "detail: IndexType compile time logic failure");
+  static_assert(true  == std::is_same<std::uint32_t, typename OWS::detail::vrnt::IndexType<65536>::type>::value, "detail: IndexType compile time logic failure");
+
   static_assert(0 == OWS::detail::vrnt::IFromType<0, bool,  bool, char, int, float>::value, "detail: IFromType compile time logic failure");
   static_assert(1 == OWS::detail::vrnt::IFromType<0, char,  bool, char, int, float>::value, "detail: IFromType compile time logic failure");
   static_assert(2 == OWS::detail::vrnt::IFromType<0, int,   bool, char, int, float>::value, "detail: IFromType compile time logic failure");
@@ -143,213 +416,2090 @@ namespace OWS
   public:
 
     ~bad_variant_access() = default;
-    bad_variant_access() = default;
-    template <typename... Args> // args supporting string operator+=
-    explicit bad_variant_access(Args&&... args) : m_msg{ "bad_variant_access: " }
+    bad_variant_access() noexcept : m_msg{}
+    {
+      Append("bad_variant_access");
+    }
+    explicit bad_variant_access(char const* reason) noexcept : m_msg{}
+    {
+      Append("bad_variant_access: ");
+      Append(reason);
+    }
+    // get<requested> on a variant holding alternative held, formatted without allocating
+    bad_variant_access(unsigned requested, unsigned held) noexcept : m_msg{}
     {
-      int unpack[]{ 0, (m_msg += std::forward<Args>(args), 0)... };
-      static_cast<void>(unpack);
+      Append("bad_variant_access: get<");
+      Append(requested);
+      Append("> on variant ");
+      if (std::numeric_limits<unsigned>::max() == held)Append("valueless");
+      else Append(held);
     }
     bad_variant_access(bad_variant_access const&) = default;
     bad_variant_access(bad_variant_access&&) = default;
     bad_variant_access& operator=(bad_variant_access const&) = default;
     bad_variant_access& operator=(bad_variant_access&&) = default;
 
-    const char* what() const noexcept override { return m_msg.c_str(); }
+    const char* what() const noexcept override { return m_msg; }
 
   private:
-    std::string m_msg;
+
+    void Append(char const* str) noexcept
+    {
+      while (*str && m_Len + 1 < sizeof(m_msg))m_msg[m_Len++] = *str++;
+    }
+
+    void Append(unsigned value) noexcept
+    {
+      char digits[std::numeric_limits<unsigned>::digits10 + 1];
+      size_t count{ 0 };
+      do { digits[count++] = static_cast<char>('0' + value % 10); } while (value /= 10);
+      while (count && m_Len + 1 < sizeof(m_msg))m_msg[m_Len++] = digits[--count];
+    }
+
+    char m_msg[64];   // null terminated, zero initialized
+    size_t m_Len{ 0 };
   };
 
-  template <typename... Ts>
-  class alignas(Ts...) Variant
+  // handler called instead of throwing when exceptions are disabled, it must not return
+  using bad_variant_access_handler = void (*)(bad_variant_access const&);
+
+  namespace detail
   {
-  public:
+    namespace vrnt
+    {
+      inline bad_variant_access_handler& BadAccessHandler() noexcept
+      {
+        static bad_variant_access_handler s_Handler{ nullptr };
+        return s_Handler;
+      }
 
-    static_assert(true == detail::vrnt::is_unique<Ts...>::value, "variant should have unique parameter list");
+      [[noreturn]] inline void Raise(bad_variant_access const& error)
+      {
+#if OWS_VARIANT_NO_EXCEPTIONS
+        if (bad_variant_access_handler handler = BadAccessHandler())handler(error);
+        std::abort();
+#else
+        throw error;
+#endif
+      }
 
-    unsigned index() const noexcept { return m_Idx; }
-    bool valueless() const noexcept { return m_Idx == s_Valueless; }
+      // out of line failure paths, keep message formatting and the throw away from inlined call sites
+      [[noreturn]] OWS_VRNT_COLD inline void BadAccess(unsigned requested, unsigned held)
+      {
+        Raise(bad_variant_access{ requested, held });
+      }
 
-    template <typename T>
-    bool holds_alternative() const noexcept
-    {
-      constexpr auto typeIdx{ detail::vrnt::IFromType<0, T, Ts...>::value };
-      return typeIdx == m_Idx;
+      [[noreturn]] OWS_VRNT_COLD inline void BadAccess(char const* reason)
+      {
+        Raise(bad_variant_access{ reason });
+      }
     }
+  }
 
-    template <typename T>
-    typename std::enable_if<detail::vrnt::is_any<T, Ts...>::value, T*>::type get_if() noexcept
+  // install the handler used in OWS_VARIANT_NO_EXCEPTIONS builds, returns the previous one, nullptr aborts
+  inline bad_variant_access_handler set_bad_variant_access_handler(bad_variant_access_handler handler) noexcept
+  {
+    bad_variant_access_handler previous{ detail::vrnt::BadAccessHandler() };
+    detail::vrnt::BadAccessHandler() = handler;
+    return previous;
+  }
+
+  // ***************************************************************************
+  // **************************************************************** boxed ****
+
+  // Per type pool allocator, blocks come from thread local free lists refilled a chunk at a time.
+  // Chunks are kept for the life of the process, a block freed on another thread joins that thread's list.
+  template <typename T>
+  class BoxPool
+  {
+  public:
+
+    using value_type = T;
+
+    BoxPool() = default;
+    template <typename U>
+    BoxPool(BoxPool<U> const&) noexcept {}
+
+    T* allocate(size_t count)
     {
-      constexpr auto typeIdx{ detail::vrnt::IFromType<0, T, Ts...>::value };
-      return typeIdx == m_Idx ? reinterpret_cast<T*>(m_Raw) : nullptr;
+      if (1 != count)return static_cast<T*>(detail::vrnt::AlignedAllocate<alignof(T)>(count * sizeof(T)));
+      State& state{ Local() };
+      if (nullptr == state.m_Free)Refill(state);
+      Block* block{ state.m_Free };
+      state.m_Free = block->m_Next;
+      return reinterpret_cast<T*>(block->m_Raw);
     }
 
-    template <typename T>
-    typename std::enable_if<detail::vrnt::is_any<T, Ts...>::value, T const*>::type get_if() const noexcept
+    void deallocate(T* ptr, size_t count) noexcept
     {
-      constexpr auto typeIdx{ detail::vrnt::IFromType<0, T, Ts...>::value };
-      return typeIdx == m_Idx ? reinterpret_cast<T const*>(m_Raw) : nullptr;
+      if (1 != count)return detail::vrnt::AlignedFree<alignof(T)>(ptr);
+      State& state{ Local() };
+      Block* block{ reinterpret_cast<Block*>(ptr) };
+      block->m_Next = state.m_Free;
+      state.m_Free = block;
     }
 
-    template <size_t I, typename T = typename std::enable_if<I < sizeof...(Ts), typename detail::vrnt::IthType<I, Ts...>::type>::type>
-    T* get_if() noexcept
+    template <typename U>
+    bool operator==(BoxPool<U> const&) const noexcept { return true; }
+    template <typename U>
+    bool operator!=(BoxPool<U> const&) const noexcept { return false; }
+
+  private:
+
+    static constexpr size_t s_ChunkBlocks{ 64 };
+
+    union Block
     {
-      return I == m_Idx ? reinterpret_cast<T*>(m_Raw) : nullptr;
-    }
+      Block* m_Next;
+      alignas(T) char m_Raw[sizeof(T)];
+    };
 
-    template <size_t I, typename T = typename std::enable_if<I < sizeof...(Ts), typename detail::vrnt::IthType<I, Ts...>::type>::type>
-    T const* get_if() const noexcept
+    struct State
     {
-      return I == m_Idx ? reinterpret_cast<T const*>(m_Raw) : nullptr;
-    }
+      Block* m_Free{ nullptr };
+    };
 
-    template <typename T>
-    typename std::enable_if<detail::vrnt::is_any<T, Ts...>::value, T&>::type get() 
+    static State& Local() noexcept
     {
-      constexpr auto typeIdx{ detail::vrnt::IFromType<0, T, Ts...>::value };
-      if (typeIdx != m_Idx)throw bad_variant_access{ "get<", std::to_string(typeIdx), "> on variant ", std::to_string(m_Idx) };
-      return reinterpret_cast<T&>(m_Raw);
+      static thread_local State s_State;
+      return s_State;
     }
-    
-    template <typename T>
-    typename std::enable_if<detail::vrnt::is_any<T, Ts...>::value, T const&>::type get() const
+
+    static void Refill(State& state)
     {
-      constexpr auto typeIdx{ detail::vrnt::IFromType<0, T, Ts...>::value };
-      if (typeIdx != m_Idx)throw bad_variant_access{ "get<", std::to_string(typeIdx), "> on variant ", std::to_string(m_Idx) };
-      return reinterpret_cast<T const&>(m_Raw);
+      Block* const chunk{ static_cast<Block*>(detail::vrnt::AlignedAllocate<alignof(Block)>(s_ChunkBlocks * sizeof(Block))) }; // kept for good
+      for (size_t i{ 0 }; i < s_ChunkBlocks; ++i)chunk[i].m_Next = i + 1 < s_ChunkBlocks ? &chunk[i + 1] : state.m_Free;
+      state.m_Free = chunk;
     }
+  };
 
-    template <size_t I, typename T = typename std::enable_if<I < sizeof...(Ts), typename detail::vrnt::IthType<I, Ts...>::type>::type>
-    T& get()
+  // Alternative marker, Variant stores T out of line through Alloc and keeps only a pointer inline.
+  // get, get_if, holds_alternative, emplace and visit see T. Alloc is default constructed for every allocation,
+  // so any state must be shared, such as a static arena. A moved from box is empty until assigned or destroyed,
+  // copies of it are empty too, a variant whose box is moved from becomes valueless.
+  template <typename T, typename Alloc = BoxPool<T>>
+  class Boxed
+  {
+    template <typename... Args>
+    struct is_self : public std::false_type{};
+
+    template <typename U>
+    struct is_self<U> : public std::is_same<Boxed, typename std::remove_cv<typename std::remove_reference<U>::type>::type>{};
+
+  public:
+
+    using value_type = T;
+    using allocator_type = Alloc;
+
+    template <typename... Args, typename = typename std::enable_if<!is_self<Args...>::value>::type>
+    explicit Boxed(Args&&... args) : m_Ptr{ Make(std::forward<Args>(args)...) } {}
+
+    Boxed(Boxed const& other) : m_Ptr{ other.m_Ptr ? Make(*other.m_Ptr) : nullptr } {}
+    Boxed(Boxed&& other) noexcept : m_Ptr{ other.m_Ptr }
     {
-      if (I != m_Idx)throw bad_variant_access{ "get<", std::to_string(I), "> on variant ", std::to_string(m_Idx) };
-      return reinterpret_cast<T&>(m_Raw);
+      other.m_Ptr = nullptr;
     }
 
-    template <size_t I, typename T = typename std::enable_if<I < sizeof...(Ts), typename detail::vrnt::IthType<I, Ts...>::type>::type>
-    T const& get() const
+    // same alternative assignment reuses the existing box
+    Boxed& operator=(Boxed const& other)
     {
-      if (I != m_Idx)throw bad_variant_access{ "get<", std::to_string(I), "> on variant ", std::to_string(m_Idx) };
-      return reinterpret_cast<T const&>(m_Raw);
+      if (other.m_Ptr)return *this = *other.m_Ptr;
+      if (m_Ptr)Free(m_Ptr);
+      m_Ptr = nullptr;
+      return *this;
     }
-
-    ~Variant() noexcept
+    Boxed& operator=(Boxed&& other) noexcept
     {
-      if (s_Valueless == m_Idx)return;
-      s_Destructors[m_Idx](this); // no need to clear index
+      std::swap(m_Ptr, other.m_Ptr);
+      return *this;
     }
-
-    template <typename T, typename... Args>
-    typename std::enable_if<detail::vrnt::is_any<T, Ts...>::value, T>::type& emplace(Args&&... args)
+    Boxed& operator=(T const& value)
     {
-      if (s_Valueless != m_Idx)s_Destructors[m_Idx](this);
-      m_Idx = detail::vrnt::IFromType<0, T, Ts...>::value;
-      return *::new (reinterpret_cast<T*>(m_Raw)) T{ std::forward<Args>(args)... };
+      if (nullptr == m_Ptr)m_Ptr = Make(value);
+      else *m_Ptr = value;
+      return *this;
     }
-
-    template <size_t I, typename T = typename std::enable_if<I < sizeof...(Ts), typename detail::vrnt::IthType<I, Ts...>::type>::type, typename... Args>
-    T& emplace(Args&&... args)
+    Boxed& operator=(T&& value)
     {
-      return emplace<T>(std::forward<Args>(args)...);
+      if (nullptr == m_Ptr)m_Ptr = Make(std::move(value));
+      else *m_Ptr = std::move(value);
+      return *this;
     }
 
-    // valueless constructor
-    Variant() = default;
-    
-    Variant(Variant const& other) : Variant{ /* idx initialized in emplace called in TAssign from s_CopyAssigns */ }
+    ~Boxed() { if (nullptr != m_Ptr)Free(m_Ptr); }
+
+    T& get() noexcept { return *m_Ptr; }
+    T const& get() const noexcept { return *m_Ptr; }
+
+    // only after being moved from
+    bool empty() const noexcept { return nullptr == m_Ptr; }
+
+  private:
+
+    template <typename... Args>
+    static T* Make(Args&&... args)
     {
-      if (s_Valueless == other.m_Idx)return;
-      s_CopyEmplace[other.m_Idx](this, const_cast<Variant*>(&other));// internal guaranteed not to modify other
+      Alloc alloc{};
+      T* ptr{ alloc.allocate(1) };
+#if OWS_VARIANT_NO_EXCEPTIONS
+      return detail::vrnt::Construct<T>(ptr, std::forward<Args>(args)...);
+#else
+      try { return detail::vrnt::Construct<T>(ptr, std::forward<Args>(args)...); }
+      catch (...) { alloc.deallocate(ptr, 1); throw; }
+#endif
     }
 
-    Variant(Variant&& other) noexcept : Variant{ /* idx initialized in emplace called in TAssign from s_MoveAssigns */ }
+    static void Free(T* ptr) noexcept
     {
-      if (s_Valueless == other.m_Idx)return;
-      s_MoveEmplace[other.m_Idx](this, &other);// internal moves other contents
-      //s_Destructors[other.m_Idx](&other);// destroy other's internal variant
-      //other.m_Idx = s_Valueless;
+      ptr->~T();
+      Alloc{}.deallocate(ptr, 1);
     }
 
-    // Value initializer
-    template <typename T, typename U = typename std::enable_if<detail::vrnt::is_any<typename detail::vrnt::remove_cvref<T>::type, Ts...>::value, T>::type>
-    explicit Variant(T&& variant) : Variant{ /* idx initialized in emplace */ }
+    T* m_Ptr;
+  };
+
+  namespace detail
+  {
+    namespace vrnt
     {
-      emplace<typename detail::vrnt::remove_cvref<U>::type>(std::forward<U>(variant));
+      // alternative as seen by users, unwraps Boxed
+      template <typename T>
+      struct Unbox
+      {
+        using type = T;
+        static constexpr T& get(T& value) noexcept { return value; }
+        static constexpr T const& get(T const& value) noexcept { return value; }
+      };
+
+      template <typename T, typename Alloc>
+      struct Unbox<Boxed<T, Alloc>>
+      {
+        using type = T;
+        static T& get(Boxed<T, Alloc>& box) noexcept { return box.get(); }
+        static T const& get(Boxed<T, Alloc> const& box) noexcept { return box.get(); }
+      };
+
+      // whether a stored alternative was left without a value by a move, only boxes can be
+      template <typename T>
+      constexpr bool MovedOut(T const&) noexcept { return false; }
+
+      template <typename T, typename Alloc>
+      inline bool MovedOut(Boxed<T, Alloc> const& box) noexcept { return box.empty(); }
+
+      template <typename T>
+      struct is_boxed : public std::false_type{};
+
+      template <typename T, typename Alloc>
+      struct is_boxed<Boxed<T, Alloc>> : public std::true_type{};
+
+      // alternative as stored, boxed when marked or when larger than OWS_VARIANT_BOX_THRESHOLD
+      template <typename T>
+      struct Stored : public std::conditional<!is_boxed<T>::value && 0 != OWS_VARIANT_BOX_THRESHOLD && (sizeof(T) > OWS_VARIANT_BOX_THRESHOLD),
+        Boxed<T>, T>{};
     }
+  }
+
+  // Opt-in, T can move to new storage by memcpy with its old storage then dropped without running ~T.
+  // True for trivially copyable types, boxes and variants of relocatable alternatives. Specialize for types such as
+  // std::unique_ptr or handle wrappers; std::string is not on libstdc++, its short buffer pointer points into itself.
+  template <typename T>
+  struct is_trivially_relocatable : public std::is_trivially_copyable<T>{};
+
+  template <typename T, typename Alloc>
+  struct is_trivially_relocatable<Boxed<T, Alloc>> : public std::true_type{};
 
-    Variant& operator=(Variant const& other)
+  // **************************************************************** boxed ****
+  // ***************************************************************************
+
+  // ***************************************************************************
+  // **************************************************************** stats ****
+
+#if OWS_VARIANT_STATS
+  // counters of one Variant instantiation, per thread or merged across threads
+  // trivial copies, and the end of life of trivially destructible variants, stay trivial and are not counted
+  template <size_t N>
+  struct variant_counters
+  {
+    std::uint64_t m_Constructions[N]; // alternative constructed, by value, copy, move or emplace
+    std::uint64_t m_Destructions[N];  // alternative destroyed, by replacement, reset or destructor
+    std::uint64_t m_SameType;         // assignment or emplace keeping the held alternative
+    std::uint64_t m_TypeChanges;      // assignment or emplace switching alternative
+    std::uint64_t m_BadAccesses;      // failed get or visit on a valueless variant
+    std::uint64_t m_Visits;           // visit calls this variant took part in
+    std::uint64_t m_VisitsOf[N];      // visit calls by held alternative, input to variant_hint_header
+
+    variant_counters& operator+=(variant_counters const& other) noexcept
     {
-      if (s_Valueless == other.m_Idx)
+      for (size_t i{ 0 }; i < N; ++i)
       {
-        if (s_Valueless != m_Idx)s_Destructors[m_Idx](this);
-        m_Idx = s_Valueless;
-        return *this;
+        m_Constructions[i] += other.m_Constructions[i];
+        m_Destructions[i] += other.m_Destructions[i];
+        m_VisitsOf[i] += other.m_VisitsOf[i];
       }
-      s_CopyEmplace[other.m_Idx](this, const_cast<Variant*>(&other));// internal guaranteed not to modify other, this idx set as side effect
+      m_SameType += other.m_SameType;
+      m_TypeChanges += other.m_TypeChanges;
+      m_BadAccesses += other.m_BadAccesses;
+      m_Visits += other.m_Visits;
       return *this;
     }
+  };
 
-    Variant& operator=(Variant&& other) noexcept
+  namespace detail
+  {
+    namespace vrnt
     {
-      if (s_Valueless == other.m_Idx)
+      // counters written by their owning thread only, atomics so a scrape from another thread reads whole values
+      template <size_t N>
+      struct StatsBlock
+      {
+        std::atomic<std::uint64_t> m_Constructions[N];
+        std::atomic<std::uint64_t> m_Destructions[N];
+        std::atomic<std::uint64_t> m_SameType;
+        std::atomic<std::uint64_t> m_TypeChanges;
+        std::atomic<std::uint64_t> m_BadAccesses;
+        std::atomic<std::uint64_t> m_Visits;
+        std::atomic<std::uint64_t> m_VisitsOf[N];
+        StatsBlock* m_Next;
+        StatsBlock* m_Prev;
+      };
+
+      inline void Bump(std::atomic<std::uint64_t>& counter) noexcept
       {
-        if (s_Valueless != m_Idx)s_Destructors[m_Idx](this);
-        m_Idx = s_Valueless;
-        return *this;
+        counter.store(counter.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
       }
-      s_MoveEmplace[other.m_Idx](this, &other);// internal moves other contents, this idx set as side effect
-      //s_Destructors[other.m_Idx](&other);// destroy other's internal variant
-      //other.m_Idx = s_Valueless;
-      return *this;
-    }
 
-    // variant type combined copy and move assignment operator requires respective type constructor to be available
-    template <typename T, typename U = typename std::enable_if<detail::vrnt::is_any<typename detail::vrnt::remove_cvref<T>::type, Ts...>::value, T>::type>
-    Variant& operator=(T&& rhs) noexcept
-    {
-      emplace<typename detail::vrnt::remove_cvref<T>::type>(std::forward<T>(rhs));
-      return *this;
+      // One registry per instantiation of stored alternatives Ts, linking every live thread's block.
+      // Exiting threads fold their block into m_Retired. The registry is never destroyed so late thread exits stay safe.
+      template <typename... Ts>
+      struct Stats
+      {
+        static constexpr size_t s_Count{ sizeof...(Ts) };
+        using Block = StatsBlock<s_Count>;
+        using Counters = variant_counters<s_Count>;
+
+        struct Registry
+        {
+          std::mutex m_Lock;
+          Block* m_Live{ nullptr };
+          Counters m_Retired{};
+        };
+
+        struct Local
+        {
+          Local() noexcept
+          {
+            Clear(m_Block);
+            Registry& registry{ Global() };
+            std::lock_guard<std::mutex> lock{ registry.m_Lock };
+            m_Block.m_Prev = nullptr;
+            m_Block.m_Next = registry.m_Live;
+            if (registry.m_Live)registry.m_Live->m_Prev = &m_Block;
+            registry.m_Live = &m_Block;
+          }
+
+          ~Local()
+          {
+            Registry& registry{ Global() };
+            std::lock_guard<std::mutex> lock{ registry.m_Lock };
+            registry.m_Retired += Read(m_Block);
+            if (m_Block.m_Prev)m_Block.m_Prev->m_Next = m_Block.m_Next;
+            else registry.m_Live = m_Block.m_Next;
+            if (m_Block.m_Next)m_Block.m_Next->m_Prev = m_Block.m_Prev;
+          }
+
+          Block m_Block;
+        };
+
+        static Registry& Global() noexcept
+        {
+          static Registry* const s_Registry{ new Registry };
+          return *s_Registry;
+        }
+
+        static Block& Mine() noexcept
+        {
+          static thread_local Local s_Local;
+          return s_Local.m_Block;
+        }
+
+        static void Clear(Block& block) noexcept
+        {
+          for (size_t i{ 0 }; i < s_Count; ++i)
+          {
+            block.m_Constructions[i].store(0, std::memory_order_relaxed);
+            block.m_Destructions[i].store(0, std::memory_order_relaxed);
+            block.m_VisitsOf[i].store(0, std::memory_order_relaxed);
+          }
+          block.m_SameType.store(0, std::memory_order_relaxed);
+          block.m_TypeChanges.store(0, std::memory_order_relaxed);
+          block.m_BadAccesses.store(0, std::memory_order_relaxed);
+          block.m_Visits.store(0, std::memory_order_relaxed);
+        }
+
+        static Counters Read(Block const& block) noexcept
+        {
+          Counters counters;
+          for (size_t i{ 0 }; i < s_Count; ++i)
+          {
+            counters.m_Constructions[i] = block.m_Constructions[i].load(std::memory_order_relaxed);
+            counters.m_Destructions[i] = block.m_Destructions[i].load(std::memory_order_relaxed);
+            counters.m_VisitsOf[i] = block.m_VisitsOf[i].load(std::memory_order_relaxed);
+          }
+          counters.m_SameType = block.m_SameType.load(std::memory_order_relaxed);
+          counters.m_TypeChanges = block.m_TypeChanges.load(std::memory_order_relaxed);
+          counters.m_BadAccesses = block.m_BadAccesses.load(std::memory_order_relaxed);
+          counters.m_Visits = block.m_Visits.load(std::memory_order_relaxed);
+          return counters;
+        }
+
+        static Counters Merged() noexcept
+        {
+          Registry& registry{ Global() };
+          std::lock_guard<std::mutex> lock{ registry.m_Lock };
+          Counters counters{ registry.m_Retired };
+          for (Block* block{ registry.m_Live }; block; block = block->m_Next)counters += Read(*block);
+          return counters;
+        }
+
+        // own thread only, another thread's block is written by its owner alone
+        static void Reset() noexcept
+        {
+          Registry& registry{ Global() };
+          std::lock_guard<std::mutex> lock{ registry.m_Lock };
+          registry.m_Retired = Counters{};
+          Clear(Mine());
+        }
+
+        // alternative idx replaced the alternative previous, or filled a valueless variant
+        static void Emplaced(size_t previous, size_t idx) noexcept
+        {
+          Block& block{ Mine() };
+          Bump(block.m_Constructions[idx]);
+          if (previous == idx)Bump(block.m_SameType);
+          else if (previous < s_Count)Bump(block.m_TypeChanges);
+        }
+
+        static void Constructed(size_t idx) noexcept { Bump(Mine().m_Constructions[idx]); }
+        static void Destroyed(size_t idx) noexcept { Bump(Mine().m_Destructions[idx]); }
+        static void Assigned() noexcept { Bump(Mine().m_SameType); }
+        static void BadAccess() noexcept { Bump(Mine().m_BadAccesses); }
+        static void Visited(size_t idx) noexcept
+        {
+          Block& block{ Mine() };
+          Bump(block.m_Visits);
+          if (idx < s_Count)Bump(block.m_VisitsOf[idx]);
+        }
+      };
+
+      template <typename V>
+      struct StatsOf;
+
+      template <typename... Ts>
+      struct StatsOf<Variant<Ts...>> : public type_identity<Stats<typename Stored<Ts>::type...>>{};
+
+      inline void Visited() noexcept {}
+
+      template <typename V, typename... Vs>
+      inline void Visited(V const& v, Vs const&... vs) noexcept
+      {
+        StatsOf<typename remove_cvref<V>::type>::type::Visited(v.index());
+        if (v.valueless())StatsOf<typename remove_cvref<V>::type>::type::BadAccess();
+        Visited(vs...);
+      }
     }
+  }
 
-  private:
+  // counters of Variant V summed over every thread, exited threads included
+  template <typename V>
+  inline typename detail::vrnt::StatsOf<V>::type::Counters variant_stats() noexcept
+  {
+    return detail::vrnt::StatsOf<V>::type::Merged();
+  }
 
-    template <typename T>
-    static inline constexpr void TDestructor(Variant* thisPtr) noexcept
+  // counters of Variant V on the calling thread alone
+  template <typename V>
+  inline typename detail::vrnt::StatsOf<V>::type::Counters variant_thread_stats() noexcept
+  {
+    return detail::vrnt::StatsOf<V>::type::Read(detail::vrnt::StatsOf<V>::type::Mine());
+  }
+
+  // zeroes the calling thread's and exited threads' counters of Variant V
+  template <typename V>
+  inline void reset_variant_stats() noexcept
+  {
+    detail::vrnt::StatsOf<V>::type::Reset();
+  }
+
+  // Source of a variant_hot_alternatives specialization for V from visits counted so far on every thread, alternatives
+  // held in at least minShare of the visits and most frequent first, at most maxHot of them. typeName spells V as the
+  // including code names it. Written to a header that is included after the variant is declared, hints take effect
+  // in builds without OWS_VARIANT_STATS too.
+  template <typename V>
+  inline std::string variant_hint_header(std::string const& typeName, double minShare = 0.05, size_t maxHot = 3)
+  {
+    using Stats = typename detail::vrnt::StatsOf<V>::type;
+    typename Stats::Counters const counters{ Stats::Merged() };
+
+    size_t order[Stats::s_Count];
+    for (size_t i{ 0 }; i < Stats::s_Count; ++i)
     {
-      thisPtr->get<T>().~T();
+      size_t j{ i };
+      for (; j > 0 && counters.m_VisitsOf[order[j - 1]] < counters.m_VisitsOf[i]; --j)order[j] = order[j - 1];
+      order[j] = i;
     }
 
-    template <typename T>
-    static inline constexpr void TEmplace(Variant* lhsPtr, Variant* rhsPtr)
-    { // internal call assumed, no const checking
-      lhsPtr->emplace<typename detail::vrnt::remove_cvref<T>::type>(reinterpret_cast<T>(rhsPtr->m_Raw));
+    std::string list;
+    std::string counts;
+    for (size_t i{ 0 }; i < Stats::s_Count && i < maxHot; ++i)
+    {
+      std::uint64_t const visits{ counters.m_VisitsOf[order[i]] };
+      if (0 == visits || static_cast<double>(visits) < minShare * static_cast<double>(counters.m_Visits))break;
+      list += (list.empty() ? "" : ", ") + std::to_string(order[i]);
+      counts += ", " + std::to_string(order[i]) + ": " + std::to_string(visits);
     }
 
-    static constexpr size_t s_RawSize{ detail::vrnt::CTMM<size_t, sizeof(Ts)...>::s_max };
-    static constexpr unsigned s_Valueless{ std::numeric_limits<unsigned>::max() };
+    return "// hot alternatives from OWS_VARIANT_STATS, " + std::to_string(counters.m_Visits) + " visits" + counts + "\n"
+      "namespace OWS\n"
+      "{\n"
+      "  template <>\n"
+      "  struct variant_hot_alternatives<" + typeName + "> : public hot_alternatives<" + list + ">{};\n"
+      "}\n";
+  }
+#endif // OWS_VARIANT_STATS
 
-    // static fnptr storage = 3 * sizeof(void*) * sizeof...(Ts)
-    static constexpr void (*const s_Destructors[])(Variant*){ TDestructor<Ts>... };
-    static constexpr void (*const s_CopyEmplace[])(Variant*, Variant*){ TEmplace<Ts const&>... };
-    static constexpr void (*const s_MoveEmplace[])(Variant*, Variant*){ TEmplace<Ts&&>... };
+  // **************************************************************** stats ****
+  // ***************************************************************************
 
-    char m_Raw[s_RawSize]{};
-    unsigned m_Idx{ s_Valueless }; // current variant index
+  // ***************************************************************************
+  // ***************************************************** dispatch / storage ****
 
-  };
+  namespace detail
+  {
+    namespace vrnt
+    {
+      // ***** dispatch *****
+      // An Op provides result_type, fnptr_type, s_Count and static call<I>(args...).
+      // Dispatch runs call<idx> through an inlinable switch chain for small counts, a constexpr table otherwise.
 
-  // linkage for pre C++17 struct static inline constexpr
-  template <typename... Ts>
-  constexpr void (*const Variant<Ts...>::s_Destructors[])(Variant*);
+      static constexpr size_t s_SwitchMax{ OWS_VARIANT_SWITCH_MAX };
 
-  // linkage for pre C++17 struct static inline constexpr
-  template <typename... Ts>
-  constexpr void (*const Variant<Ts...>::s_CopyEmplace[])(Variant*, Variant*);
+      template <typename Op, typename Seq = typename make_index_sequence<Op::s_Count>::type>
+      struct DispatchTable;
 
-  // linkage for pre C++17 struct static inline constexpr
-  template <typename... Ts>
-  constexpr void (*const Variant<Ts...>::s_MoveEmplace[])(Variant*, Variant*);
+      template <typename Op, size_t... Is>
+      struct DispatchTable<Op, index_sequence<Is...>>
+      {
+        static constexpr typename Op::fnptr_type const s_Table[]{ &Op::template call<Is>... };
+      };
+
+      // linkage for pre C++17 struct static inline constexpr
+      template <typename Op, size_t... Is>
+      constexpr typename Op::fnptr_type const DispatchTable<Op, index_sequence<Is...>>::s_Table[];
+
+      // cases past the last alternative are unreachable, so the compiler drops them and a few alternatives
+      // compile to a compare chain rather than a jump table padded to 8 entries
+      template <typename Op, size_t I, typename... Args>
+      inline typename Op::result_type SwitchCase(std::true_type /* alternative */, Args&&... args)
+      {
+        return Op::template call<I>(std::forward<Args>(args)...);
+      }
+
+      template <typename Op, size_t I, typename... Args>
+      inline typename Op::result_type SwitchCase(std::false_type /* padding */, Args&&...)
+      {
+        OWS_VRNT_UNREACHABLE();
+      }
+
+      template <typename Op, size_t B, typename... Args>
+      inline typename Op::result_type DispatchSwitch(size_t idx, Args&&... args);
+
+      template <typename Op, size_t B, typename... Args>
+      inline typename Op::result_type DispatchSwitchNext(std::true_type /* more cases */, size_t idx, Args&&... args)
+      {
+        return DispatchSwitch<Op, B>(idx, std::forward<Args>(args)...);
+      }
+
+      template <typename Op, size_t B, typename... Args>
+      inline typename Op::result_type DispatchSwitchNext(std::false_type /* exhausted */, size_t, Args&&...)
+      {
+        OWS_VRNT_UNREACHABLE();
+      }
+
+      // cases B to B + 7, then the next block of 8
+      template <typename Op, size_t B, typename... Args>
+      inline typename Op::result_type DispatchSwitch(size_t idx, Args&&... args)
+      {
+        switch (idx)
+        {
+        case B + 0: return SwitchCase<Op, B + 0>(std::integral_constant<bool, (B + 0 < Op::s_Count)>{}, std::forward<Args>(args)...);
+        case B + 1: return SwitchCase<Op, B + 1>(std::integral_constant<bool, (B + 1 < Op::s_Count)>{}, std::forward<Args>(args)...);
+        case B + 2: return SwitchCase<Op, B + 2>(std::integral_constant<bool, (B + 2 < Op::s_Count)>{}, std::forward<Args>(args)...);
+        case B + 3: return SwitchCase<Op, B + 3>(std::integral_constant<bool, (B + 3 < Op::s_Count)>{}, std::forward<Args>(args)...);
+        case B + 4: return SwitchCase<Op, B + 4>(std::integral_constant<bool, (B + 4 < Op::s_Count)>{}, std::forward<Args>(args)...);
+        case B + 5: return SwitchCase<Op, B + 5>(std::integral_constant<bool, (B + 5 < Op::s_Count)>{}, std::forward<Args>(args)...);
+        case B + 6: return SwitchCase<Op, B + 6>(std::integral_constant<bool, (B + 6 < Op::s_Count)>{}, std::forward<Args>(args)...);
+        case B + 7: return SwitchCase<Op, B + 7>(std::integral_constant<bool, (B + 7 < Op::s_Count)>{}, std::forward<Args>(args)...);
+        default: return DispatchSwitchNext<Op, B + 8>(std::integral_constant<bool, (B + 8 < Op::s_Count)>{}, idx, std::forward<Args>(args)...);
+        }
+      }
+
+      template <typename Op, typename... Args>
+      inline typename Op::result_type Dispatch(std::true_type /* switch */, size_t idx, Args&&... args)
+      {
+        return DispatchSwitch<Op, 0>(idx, std::forward<Args>(args)...);
+      }
+
+      template <typename Op, typename... Args>
+      inline typename Op::result_type Dispatch(std::false_type /* table */, size_t idx, Args&&... args)
+      {
+        return DispatchTable<Op>::s_Table[idx](std::forward<Args>(args)...);
+      }
+
+      // call Op::call<idx>, idx must be less than Op::s_Count
+      template <typename Op, typename... Args>
+      inline typename Op::result_type Dispatch(size_t idx, Args&&... args)
+      {
+        return Dispatch<Op>(std::integral_constant<bool, Op::s_Count <= s_SwitchMax>{}, idx, std::forward<Args>(args)...);
+      }
+
+      // hot indices are tested first, each branch marked likely, the switch or table serves the rest
+      template <typename Op, typename... Args>
+      inline typename Op::result_type DispatchHot(index_sequence<>, size_t idx, Args&&... args)
+      {
+        return Dispatch<Op>(idx, std::forward<Args>(args)...);
+      }
+
+      template <typename Op, size_t I, size_t... Is, typename... Args>
+      inline typename Op::result_type DispatchHot(index_sequence<I, Is...>, size_t idx, Args&&... args)
+      {
+        static_assert(I < Op::s_Count, "hot alternative should be a valid index");
+        if (OWS_VRNT_LIKELY(I == idx))return Op::template call<I>(std::forward<Args>(args)...);
+        return DispatchHot<Op>(index_sequence<Is...>{}, idx, std::forward<Args>(args)...);
+      }
+
+      // ***** storage *****
+
+      template <template <typename> class Trait, typename... Ts>
+      struct all_of : public is_all<std::true_type, typename Trait<Ts>::type...>{};
+
+      template <typename... Ts>
+      struct VariantTriviallyRelocatable : public all_of<is_trivially_relocatable, Ts...>{};
+
+      template <typename... Ts>
+      struct VariantNothrowMoveConstructible : public all_of<std::is_nothrow_move_constructible, Ts...>{};
+
+      // as std::variant, a throwing move assignment or move constructor of any alternative may escape
+      template <typename... Ts>
+      struct VariantNothrowMoveAssignable : public std::integral_constant<bool,
+        all_of<std::is_nothrow_move_constructible, Ts...>::value &&
+        all_of<std::is_nothrow_move_assignable, Ts...>::value>{};
+
+      template <typename... Ts>
+      struct VariantNothrowSwappable : public VariantNothrowMoveAssignable<Ts...>{};
+
+      template <typename... Ts>
+      struct VariantTriviallyCopyAssignable : public std::integral_constant<bool,
+        all_of<std::is_trivially_copy_assignable, Ts...>::value &&
+        all_of<std::is_trivially_copy_constructible, Ts...>::value &&
+        all_of<std::is_trivially_destructible, Ts...>::value>{};
+
+      template <typename... Ts>
+      struct VariantTriviallyMoveAssignable : public std::integral_constant<bool,
+        all_of<std::is_trivially_move_assignable, Ts...>::value &&
+        all_of<std::is_trivially_move_constructible, Ts...>::value &&
+        all_of<std::is_trivially_destructible, Ts...>::value>{};
+
+      template <size_t I>
+      using index_constant = std::integral_constant<size_t, I>;
+
+      // alternatives as raw bytes, built by placement new and read through reinterpret_cast
+      template <typename... Ts>
+      struct RawBytes
+      {
+        RawBytes() noexcept : m_Bytes{} {}
+
+        template <size_t I, typename... Args>
+        explicit RawBytes(index_constant<I>, Args&&... args)
+        {
+          Construct<typename IthType<I, Ts...>::type>(m_Bytes, std::forward<Args>(args)...);
+        }
+
+        template <typename T>
+        T const& get() const noexcept { return reinterpret_cast<T const&>(m_Bytes); }
+
+        char m_Bytes[RawSize<Ts...>::value];
+      };
+
+      // alternatives as union members, construction and access are constexpr for literal alternatives
+      template <typename... Ts>
+      union RecursiveUnion{};
+
+      template <size_t I, typename T>
+      struct UnionAt
+      {
+        template <typename U>
+        static constexpr T const& get(U const& u) noexcept { return UnionAt<I - 1, T>::get(u.m_Tail); }
+      };
+
+      template <typename T>
+      struct UnionAt<0, T>
+      {
+        template <typename U>
+        static constexpr T const& get(U const& u) noexcept { return u.m_Head; }
+      };
+
+      template <typename T, typename... Ts>
+      union RecursiveUnion<T, Ts...>
+      {
+        constexpr RecursiveUnion() noexcept : m_None{} {}
+
+        template <typename... Args>
+        constexpr explicit RecursiveUnion(index_constant<0>, Args&&... args) : RecursiveUnion{ ParenInit<T, Args...>{}, std::forward<Args>(args)... } {}
+
+        template <typename... Args>
+        constexpr RecursiveUnion(std::true_type /* parentheses */, Args&&... args) : m_Head( std::forward<Args>(args)... ) {}
+
+        template <typename... Args>
+        constexpr RecursiveUnion(std::false_type /* braces */, Args&&... args) : m_Head{ std::forward<Args>(args)... } {}
+
+        template <size_t I, typename... Args>
+        constexpr explicit RecursiveUnion(index_constant<I>, Args&&... args) : m_Tail{ index_constant<I - 1>{}, std::forward<Args>(args)... } {}
+
+        template <typename U>
+        constexpr U const& get() const noexcept { return UnionAt<IFromType<0, U, T, Ts...>::value, U>::get(*this); }
+
+        char m_None;
+        T m_Head;
+        RecursiveUnion<Ts...> m_Tail;
+      };
+
+      // union storage when alternatives are literal and the list is short, its depth is linear in the alternative count
+      template <typename... Ts>
+      struct UnionStorage : public std::integral_constant<bool,
+        VariantTriviallyCopyAssignable<Ts...>::value && VariantTriviallyMoveAssignable<Ts...>::value &&
+        (sizeof...(Ts) <= OWS_VARIANT_CONSTEXPR_MAX) && !(OWS_VARIANT_PACKED_TAG && s_UnalignedAccess)>{};
+
+      // storage, index and type erased special member tables
+      template <typename... Ts>
+      class alignas(VariantAlign<Ts...>::value) VariantData
+      {
+      public:
+
+        VariantData() = default;
+
+        // constructs alternative I in place
+        template <size_t I, typename... Args>
+        OWS_VRNT_STATS_CONSTEXPR explicit VariantData(index_constant<I> tag, Args&&... args) : m_Raw{ tag, std::forward<Args>(args)... }, m_Idx{ static_cast<typename IndexType<sizeof...(Ts)>::type>(I) }
+        {
+          OWS_VRNT_STAT(Stats<Ts...>::Constructed(I);)
+        }
+
+      protected:
+
+        using index_type = typename IndexType<sizeof...(Ts)>::type;
+        using Storage = typename std::conditional<UnionStorage<Ts...>::value, RecursiveUnion<Ts...>, RawBytes<Ts...>>::type;
+
+        template <typename T>
+        T& TRef() noexcept { return const_cast<T&>(m_Raw.template get<T>()); }
+
+        template <typename T>
+        constexpr T const& TRef() const noexcept { return m_Raw.template get<T>(); }
+
+        void TDestroy() noexcept
+        {
+          if (s_Valueless != m_Idx)Dispatch<DestroyOp>(m_Idx, this); // no need to clear index
+        }
+
+        template <typename T, typename... Args>
+        T& TEmplace(Args&&... args)
+        {
+          OWS_VRNT_STAT(Stats<Ts...>::Emplaced(m_Idx, IFromType<0, T, Ts...>::value);)
+          return TEmplaceAs<T>(std::integral_constant<bool, !OWS_VARIANT_NEVER_VALUELESS || std::is_nothrow_constructible<T, Args...>::value>{},
+            std::forward<Args>(args)...);
+        }
+
+        // valueless while T is built, a throwing constructor leaves the variant valueless rather than claiming a T
+        template <typename T, typename... Args>
+        T& TEmplaceAs(std::true_type /* in place */, Args&&... args)
+        {
+          TDestroy();
+          m_Idx = s_Valueless;
+          T& value{ *Construct<T>(&m_Raw, std::forward<Args>(args)...) };
+          m_Idx = static_cast<index_type>(IFromType<0, T, Ts...>::value);
+          return value;
+        }
+
+        // OWS_VARIANT_NEVER_VALUELESS, T is built aside so a throw keeps the held alternative, then moved in without throwing
+        template <typename T, typename... Args>
+        T& TEmplaceAs(std::false_type /* aside */, Args&&... args)
+        {
+          struct Aside
+          {
+            ~Aside() { m_Value->~T(); }
+            T* m_Value;
+          };
+
+          typename std::aligned_storage<sizeof(T), alignof(T)>::type buffer;
+          Aside const aside{ Construct<T>(&buffer, std::forward<Args>(args)...) };
+          return TEmplaceAs<T>(std::true_type{}, std::move(*aside.m_Value));
+        }
+
+        void TReset() noexcept
+        {
+          TDestroy();
+          m_Idx = s_Valueless;
+        }
+
+        void TCopy(VariantData const& other)
+        {
+          if (s_Valueless == other.m_Idx)return TReset();
+          Dispatch<FromOp<false, false>>(other.m_Idx, this, const_cast<VariantData*>(&other));// internal guaranteed not to modify other, this idx set as side effect
+        }
+
+        void TMove(VariantData&& other)
+        {
+          if (s_Valueless == other.m_Idx)return TReset();
+          Dispatch<FromOp<true, false>>(other.m_Idx, this, &other);// internal moves other contents, this idx set as side effect
+        }
+
+        void TCopyAssign(VariantData const& other)
+        {
+          if (s_Valueless == other.m_Idx)return TReset();
+          Dispatch<FromOp<false, true>>(other.m_Idx, this, const_cast<VariantData*>(&other));// internal guaranteed not to modify other, this idx set as side effect
+        }
+
+        void TMoveAssign(VariantData&& other)
+        {
+          if (s_Valueless == other.m_Idx)return TReset();
+          Dispatch<FromOp<true, true>>(other.m_Idx, this, &other);// internal moves other contents, this idx set as side effect
+        }
+
+        // same alternative assigns in place, keeping resources such as capacity, otherwise rebuilds
+        template <typename T, typename U>
+        void TAssign(U&& value)
+        {
+          if (IFromType<0, T, Ts...>::value == m_Idx)
+          {
+            OWS_VRNT_STAT(Stats<Ts...>::Assigned();)
+            TRef<T>() = std::forward<U>(value);
+          }
+          else TEmplace<T>(std::forward<U>(value));
+        }
+
+        struct DestroyOp
+        {
+          using result_type = void;
+          using fnptr_type = void (*)(VariantData*);
+          static constexpr size_t s_Count{ sizeof...(Ts) };
+
+          template <size_t I, typename T = typename IthType<I, Ts...>::type>
+          static void call(VariantData* thisPtr) noexcept
+          {
+            OWS_VRNT_STAT(Stats<Ts...>::Destroyed(I);)
+            thisPtr->TRef<T>().~T();
+          }
+        };
+
+        // copy or move the alternative of rhs into lhs, by emplace or by TAssign
+        template <bool Move, bool Assign>
+        struct FromOp
+        {
+          using result_type = void;
+          using fnptr_type = void (*)(VariantData*, VariantData*);
+          static constexpr size_t s_Count{ sizeof...(Ts) };
+
+          template <size_t I, typename T = typename IthType<I, Ts...>::type>
+          static void call(VariantData* lhsPtr, VariantData* rhsPtr)
+          { // internal call assumed, no const checking
+            using Src = typename std::conditional<Move, T&&, T const&>::type;
+            from<T>(std::integral_constant<bool, Assign>{}, lhsPtr, static_cast<Src>(rhsPtr->TRef<T>()));
+            if (Move && MovedOut(rhsPtr->TRef<T>()))rhsPtr->TReset();// a stolen box leaves rhs valueless, not holding nothing
+          }
+
+          template <typename T, typename U>
+          static void from(std::false_type /* emplace */, VariantData* lhsPtr, U&& src) { lhsPtr->TEmplace<T>(std::forward<U>(src)); }
+
+          template <typename T, typename U>
+          static void from(std::true_type /* assign */, VariantData* lhsPtr, U&& src) { lhsPtr->TAssign<T>(std::forward<U>(src)); }
+        };
+
+        // same alternative swaps in place, otherwise each alternative is relocated once
+        void TSwap(VariantData& other) noexcept(VariantNothrowSwappable<Ts...>::value)
+        {
+          if (m_Idx == other.m_Idx)
+          {
+            if (s_Valueless != m_Idx)Dispatch<SwapOp>(m_Idx, this, &other);
+          }
+          else TSwapAs(VariantTriviallyRelocatable<Ts...>{}, other);
+        }
+
+        void TSwapAs(std::true_type /* relocatable */, VariantData& other) noexcept
+        {
+          alignas(Storage) unsigned char tmp[sizeof(Storage)];
+          std::memcpy(tmp, static_cast<void*>(&m_Raw), sizeof(Storage));
+          std::memcpy(static_cast<void*>(&m_Raw), static_cast<void*>(&other.m_Raw), sizeof(Storage));
+          std::memcpy(static_cast<void*>(&other.m_Raw), tmp, sizeof(Storage));
+          std::swap(m_Idx, other.m_Idx);
+        }
+
+        void TSwapAs(std::false_type /* per alternative */, VariantData& other)
+        {
+          if (s_Valueless == m_Idx)return Dispatch<RelocateOp>(other.m_Idx, this, &other);
+          if (s_Valueless == other.m_Idx)return Dispatch<RelocateOp>(m_Idx, &other, this);
+          Dispatch<ExchangeOp>(m_Idx, this, &other);
+        }
+
+        // move constructs rhs's alternative into valueless lhs and ends it in rhs, a throwing move leaves rhs as it was
+        struct RelocateOp
+        {
+          using result_type = void;
+          using fnptr_type = void (*)(VariantData*, VariantData*);
+          static constexpr size_t s_Count{ sizeof...(Ts) };
+
+          template <size_t I, typename T = typename IthType<I, Ts...>::type>
+          static void call(VariantData* lhsPtr, VariantData* rhsPtr)
+          {
+            Construct<T>(&lhsPtr->m_Raw, std::move(rhsPtr->TRef<T>()));
+            lhsPtr->m_Idx = static_cast<index_type>(I);
+            OWS_VRNT_STAT(Stats<Ts...>::Constructed(I); Stats<Ts...>::Destroyed(I);)
+            rhsPtr->TRef<T>().~T();
+            rhsPtr->m_Idx = s_Valueless;
+          }
+        };
+
+        struct SwapOp
+        {
+          using result_type = void;
+          using fnptr_type = void (*)(VariantData*, VariantData*);
+          static constexpr size_t s_Count{ sizeof...(Ts) };
+
+          template <size_t I, typename T = typename IthType<I, Ts...>::type>
+          static void call(VariantData* lhsPtr, VariantData* rhsPtr)
+          {
+            using std::swap;
+            swap(lhsPtr->TRef<T>(), rhsPtr->TRef<T>());
+          }
+        };
+
+        // lhs's alternative waits in a local while rhs's relocates over, one dispatch on each index
+        struct ExchangeOp
+        {
+          using result_type = void;
+          using fnptr_type = void (*)(VariantData*, VariantData*);
+          static constexpr size_t s_Count{ sizeof...(Ts) };
+
+          template <size_t I, typename T = typename IthType<I, Ts...>::type>
+          static void call(VariantData* lhsPtr, VariantData* rhsPtr)
+          {
+            T held(std::move(lhsPtr->TRef<T>()));
+            lhsPtr->TRef<T>().~T();
+            lhsPtr->m_Idx = s_Valueless;
+            Dispatch<RelocateOp>(rhsPtr->m_Idx, lhsPtr, rhsPtr);
+            Construct<T>(&rhsPtr->m_Raw, std::move(held));
+            rhsPtr->m_Idx = static_cast<index_type>(I);
+          }
+        };
+
+        static constexpr size_t s_RawSize{ RawSize<Ts...>::value };
+        static constexpr index_type s_Valueless{ std::numeric_limits<index_type>::max() };
+
+        Storage m_Raw{};
+        index_type m_Idx{ s_Valueless }; // current variant index
+      };
+
+      // Each layer below implements one special member, or leaves it implicit (trivial)
+      // when every alternative is trivial for it, so Variant is only as non-trivial as its alternatives.
+
+      template <bool Trivial, typename... Ts>
+      struct VariantDestroy : public VariantData<Ts...>
+      {
+        using VariantData<Ts...>::VariantData;
+        VariantDestroy() = default;
+        VariantDestroy(VariantDestroy const&) = default;
+        VariantDestroy(VariantDestroy&&) = default;
+        VariantDestroy& operator=(VariantDestroy const&) = default;
+        VariantDestroy& operator=(VariantDestroy&&) = default;
+        ~VariantDestroy() noexcept { this->TDestroy(); }
+      };
+
+      template <typename... Ts>
+      struct VariantDestroy<true, Ts...> : public VariantData<Ts...>
+      {
+        using VariantData<Ts...>::VariantData;
+      };
+
+      template <bool Trivial, typename... Ts>
+      struct VariantCopyCtor : public VariantDestroy<all_of<std::is_trivially_destructible, Ts...>::value, Ts...>
+      {
+        using Base = VariantDestroy<all_of<std::is_trivially_destructible, Ts...>::value, Ts...>;
+        using Base::Base;
+        VariantCopyCtor() = default;
+        VariantCopyCtor(VariantCopyCtor const& other) : Base{ /* idx initialized in emplace called from FromOp */ }
+        {
+          this->TCopy(other);
+        }
+        VariantCopyCtor(VariantCopyCtor&&) = default;
+        VariantCopyCtor& operator=(VariantCopyCtor const&) = default;
+        VariantCopyCtor& operator=(VariantCopyCtor&&) = default;
+      };
+
+      template <typename... Ts>
+      struct VariantCopyCtor<true, Ts...> : public VariantDestroy<all_of<std::is_trivially_destructible, Ts...>::value, Ts...>
+      {
+        using VariantDestroy<all_of<std::is_trivially_destructible, Ts...>::value, Ts...>::VariantDestroy;
+      };
+
+      template <bool Trivial, typename... Ts>
+      struct VariantMoveCtor : public VariantCopyCtor<all_of<std::is_trivially_copy_constructible, Ts...>::value, Ts...>
+      {
+        using Base = VariantCopyCtor<all_of<std::is_trivially_copy_constructible, Ts...>::value, Ts...>;
+        using Base::Base;
+        VariantMoveCtor() = default;
+        VariantMoveCtor(VariantMoveCtor const&) = default;
+        VariantMoveCtor(VariantMoveCtor&& other) noexcept(VariantNothrowMoveConstructible<Ts...>::value) : Base{ /* idx initialized in emplace called from FromOp */ }
+        {
+          this->TMove(std::move(other));// internal moves other contents, other keeps its moved from alternative
+        }
+        VariantMoveCtor& operator=(VariantMoveCtor const&) = default;
+        VariantMoveCtor& operator=(VariantMoveCtor&&) = default;
+      };
+
+      template <typename... Ts>
+      struct VariantMoveCtor<true, Ts...> : public VariantCopyCtor<all_of<std::is_trivially_copy_constructible, Ts...>::value, Ts...>
+      {
+        using VariantCopyCtor<all_of<std::is_trivially_copy_constructible, Ts...>::value, Ts...>::VariantCopyCtor;
+      };
+
+      template <bool Trivial, typename... Ts>
+      struct VariantCopyAssign : public VariantMoveCtor<all_of<std::is_trivially_move_constructible, Ts...>::value, Ts...>
+      {
+        using VariantMoveCtor<all_of<std::is_trivially_move_constructible, Ts...>::value, Ts...>::VariantMoveCtor;
+        VariantCopyAssign() = default;
+        VariantCopyAssign(VariantCopyAssign const&) = default;
+        VariantCopyAssign(VariantCopyAssign&&) = default;
+        VariantCopyAssign& operator=(VariantCopyAssign const& other)
+        {
+          this->TCopyAssign(other);
+          return *this;
+        }
+        VariantCopyAssign& operator=(VariantCopyAssign&&) = default;
+      };
+
+      template <typename... Ts>
+      struct VariantCopyAssign<true, Ts...> : public VariantMoveCtor<all_of<std::is_trivially_move_constructible, Ts...>::value, Ts...>
+      {
+        using VariantMoveCtor<all_of<std::is_trivially_move_constructible, Ts...>::value, Ts...>::VariantMoveCtor;
+      };
+
+      template <bool Trivial, typename... Ts>
+      struct VariantMoveAssign : public VariantCopyAssign<VariantTriviallyCopyAssignable<Ts...>::value, Ts...>
+      {
+        using VariantCopyAssign<VariantTriviallyCopyAssignable<Ts...>::value, Ts...>::VariantCopyAssign;
+        VariantMoveAssign() = default;
+        VariantMoveAssign(VariantMoveAssign const&) = default;
+        VariantMoveAssign(VariantMoveAssign&&) = default;
+        VariantMoveAssign& operator=(VariantMoveAssign const&) = default;
+        VariantMoveAssign& operator=(VariantMoveAssign&& other) noexcept(VariantNothrowMoveAssignable<Ts...>::value)
+        {
+          this->TMoveAssign(std::move(other));// internal moves other contents, this idx set as side effect
+          return *this;
+        }
+      };
+
+      template <typename... Ts>
+      struct VariantMoveAssign<true, Ts...> : public VariantCopyAssign<VariantTriviallyCopyAssignable<Ts...>::value, Ts...>
+      {
+        using VariantCopyAssign<VariantTriviallyCopyAssignable<Ts...>::value, Ts...>::VariantCopyAssign;
+      };
+
+      template <typename... Ts>
+      using VariantBase = VariantMoveAssign<VariantTriviallyMoveAssignable<Ts...>::value, Ts...>;
+    }
+  }
+
+  // ***************************************************** dispatch / storage ****
+  // ***************************************************************************
+
+  template <typename... Ts>
+  class Variant : public detail::vrnt::VariantBase<typename detail::vrnt::Stored<Ts>::type...>
+  {
+    using Base = detail::vrnt::VariantBase<typename detail::vrnt::Stored<Ts>::type...>;
+    using Base::m_Idx;
+    using Base::s_Valueless;
+
+    // user facing alternatives unwrap Boxed, storage may hold the box
+    template <typename T>
+    using IsAlt = detail::vrnt::is_any<T, typename detail::vrnt::Unbox<Ts>::type...>;
+
+    template <typename T>
+    using IndexOf = detail::vrnt::IFromType<0, T, typename detail::vrnt::Unbox<Ts>::type...>;
+
+    template <size_t I>
+    using StoredAt = typename detail::vrnt::Stored<typename detail::vrnt::IthType<I, Ts...>::type>::type;
+
+    template <size_t I>
+    using AltAt = detail::vrnt::Unbox<StoredAt<I>>;
+
+  public:
+
+    static_assert(true == detail::vrnt::is_unique<typename detail::vrnt::Unbox<Ts>::type...>::value, "variant should have unique parameter list");
+    static_assert(!OWS_VARIANT_NEVER_VALUELESS || detail::vrnt::all_of<std::is_nothrow_move_constructible, typename detail::vrnt::Stored<Ts>::type...>::value,
+      "never valueless variant alternatives should be nothrow move constructible, box them otherwise");
+
+    friend struct detail::vrnt::Access;
+
+    constexpr unsigned index() const noexcept { return s_Valueless == m_Idx ? std::numeric_limits<unsigned>::max() : m_Idx; }
+    constexpr bool valueless() const noexcept { return m_Idx == s_Valueless; }
+
+    template <typename T>
+    constexpr bool holds_alternative() const noexcept
+    {
+      return IndexOf<T>::value == m_Idx;
+    }
+
+    template <typename T>
+    typename std::enable_if<IsAlt<T>::value, T*>::type get_if() noexcept
+    {
+      return get_if<IndexOf<T>::value>();
+    }
+
+    template <typename T>
+    constexpr typename std::enable_if<IsAlt<T>::value, T const*>::type get_if() const noexcept
+    {
+      return get_if<IndexOf<T>::value>();
+    }
+
+    template <size_t I, typename T = typename std::enable_if<I < sizeof...(Ts), typename AltAt<I>::type>::type>
+    T* get_if() noexcept
+    {
+      return I == m_Idx ? &AltAt<I>::get(this->template TRef<StoredAt<I>>()) : nullptr;
+    }
+
+    template <size_t I, typename T = typename std::enable_if<I < sizeof...(Ts), typename AltAt<I>::type>::type>
+    constexpr T const* get_if() const noexcept
+    {
+      return I == m_Idx ? &AltAt<I>::get(this->template TRef<StoredAt<I>>()) : nullptr;
+    }
+
+    template <typename T>
+    typename std::enable_if<IsAlt<T>::value, T&>::type get() 
+    {
+      return get<IndexOf<T>::value>();
+    }
+    
+    template <typename T>
+    constexpr typename std::enable_if<IsAlt<T>::value, T const&>::type get() const
+    {
+      return get<IndexOf<T>::value>();
+    }
+
+    template <size_t I, typename T = typename std::enable_if<I < sizeof...(Ts), typename AltAt<I>::type>::type>
+    T& get()
+    {
+      if (I != m_Idx)
+      {
+        OWS_VRNT_STAT(detail::vrnt::StatsOf<Variant>::type::BadAccess();)
+        detail::vrnt::BadAccess(static_cast<unsigned>(I), index());
+      }
+      return AltAt<I>::get(this->template TRef<StoredAt<I>>());
+    }
+
+    template <size_t I, typename T = typename std::enable_if<I < sizeof...(Ts), typename AltAt<I>::type>::type>
+    constexpr T const& get() const
+    { // single return for C++11 constexpr
+      return I == m_Idx ? AltAt<I>::get(this->template TRef<StoredAt<I>>()) :
+        (OWS_VRNT_STAT(detail::vrnt::StatsOf<Variant>::type::BadAccess(),) detail::vrnt::BadAccess(static_cast<unsigned>(I), index()), AltAt<I>::get(this->template TRef<StoredAt<I>>()));
+    }
+
+    template <typename T, typename... Args>
+    typename std::enable_if<IsAlt<T>::value, T>::type& emplace(Args&&... args)
+    {
+      return emplace<IndexOf<T>::value>(std::forward<Args>(args)...);
+    }
+
+    template <size_t I, typename T = typename std::enable_if<I < sizeof...(Ts), typename AltAt<I>::type>::type, typename... Args>
+    T& emplace(Args&&... args)
+    {
+      return AltAt<I>::get(this->template TEmplace<StoredAt<I>>(std::forward<Args>(args)...));
+    }
+
+    template <typename T, typename E, typename... Args>
+    typename std::enable_if<IsAlt<T>::value, T>::type& emplace(std::initializer_list<E> list, Args&&... args)
+    {
+      return emplace<IndexOf<T>::value>(list, std::forward<Args>(args)...);
+    }
+
+    template <size_t I, typename E, typename T = typename std::enable_if<I < sizeof...(Ts), typename AltAt<I>::type>::type, typename... Args>
+    T& emplace(std::initializer_list<E> list, Args&&... args)
+    {
+      return AltAt<I>::get(this->template TEmplace<StoredAt<I>>(list, std::forward<Args>(args)...));
+    }
+
+    // valueless constructor
+    Variant() = default;
+
+    // special members are trivial when every alternative's are, see detail::vrnt::VariantBase
+    Variant(Variant const&) = default;
+    Variant(Variant&&) = default;
+    Variant& operator=(Variant const&) = default;
+    Variant& operator=(Variant&&) = default;
+    ~Variant() = default;
+
+    // Value initializer, constructs in place, constexpr for literal alternatives
+    template <typename T, typename U = typename std::enable_if<IsAlt<typename detail::vrnt::remove_cvref<T>::type>::value, T>::type>
+    OWS_VRNT_STATS_CONSTEXPR explicit Variant(T&& variant) : Base{ detail::vrnt::index_constant<IndexOf<typename detail::vrnt::remove_cvref<U>::type>::value>{}, std::forward<U>(variant) } {}
+
+    // In place initializers, args go straight to the alternative's constructor in storage, no temporary alternative
+    template <typename T, typename = typename std::enable_if<IsAlt<T>::value>::type, typename... Args>
+    OWS_VRNT_STATS_CONSTEXPR explicit Variant(in_place_type_t<T>, Args&&... args) : Base{ detail::vrnt::index_constant<IndexOf<T>::value>{}, std::forward<Args>(args)... } {}
+
+    template <typename T, typename E, typename = typename std::enable_if<IsAlt<T>::value>::type, typename... Args>
+    OWS_VRNT_STATS_CONSTEXPR explicit Variant(in_place_type_t<T>, std::initializer_list<E> list, Args&&... args) : Base{ detail::vrnt::index_constant<IndexOf<T>::value>{}, list, std::forward<Args>(args)... } {}
+
+    template <size_t I, typename = typename std::enable_if<I < sizeof...(Ts)>::type, typename... Args>
+    OWS_VRNT_STATS_CONSTEXPR explicit Variant(in_place_index_t<I>, Args&&... args) : Base{ detail::vrnt::index_constant<I>{}, std::forward<Args>(args)... } {}
+
+    template <size_t I, typename E, typename = typename std::enable_if<I < sizeof...(Ts)>::type, typename... Args>
+    OWS_VRNT_STATS_CONSTEXPR explicit Variant(in_place_index_t<I>, std::initializer_list<E> list, Args&&... args) : Base{ detail::vrnt::index_constant<I>{}, list, std::forward<Args>(args)... } {}
+
+    // variant type combined copy and move assignment operator requires respective type constructor to be available
+    template <typename T, typename U = typename std::enable_if<IsAlt<typename detail::vrnt::remove_cvref<T>::type>::value, T>::type>
+    Variant& operator=(T&& rhs) noexcept(
+      std::is_nothrow_assignable<StoredAt<IndexOf<typename detail::vrnt::remove_cvref<T>::type>::value>&, T&&>::value &&
+      std::is_nothrow_constructible<StoredAt<IndexOf<typename detail::vrnt::remove_cvref<T>::type>::value>, T&&>::value)
+    {
+      this->template TAssign<StoredAt<IndexOf<typename detail::vrnt::remove_cvref<T>::type>::value>>(std::forward<T>(rhs));
+      return *this;
+    }
+
+    // same alternative swaps through ADL swap, different ones relocate, by memcpy when is_trivially_relocatable
+    void swap(Variant& other) noexcept(detail::vrnt::VariantNothrowSwappable<typename detail::vrnt::Stored<Ts>::type...>::value)
+    {
+      this->TSwap(other);
+    }
+
+    // widening from a variant whose alternatives all appear here, in any order, one table lookup remaps the index
+    template <typename... Us, typename = typename std::enable_if<detail::vrnt::is_subset<Variant<Us...>, Variant>::value>::type>
+    Variant(Variant<Us...> const& other) : Base{}
+    {
+      detail::vrnt::Convert(*this, other);
+    }
+
+    template <typename... Us, typename = typename std::enable_if<detail::vrnt::is_subset<Variant<Us...>, Variant>::value>::type>
+    Variant(Variant<Us...>&& other) : Base{}
+    {
+      detail::vrnt::Convert(*this, std::move(other));
+    }
+
+    template <typename... Us, typename = typename std::enable_if<detail::vrnt::is_subset<Variant<Us...>, Variant>::value>::type>
+    Variant& operator=(Variant<Us...> const& other)
+    {
+      detail::vrnt::Convert(*this, other);
+      return *this;
+    }
+
+    template <typename... Us, typename = typename std::enable_if<detail::vrnt::is_subset<Variant<Us...>, Variant>::value>::type>
+    Variant& operator=(Variant<Us...>&& other)
+    {
+      detail::vrnt::Convert(*this, std::move(other));
+      return *this;
+    }
+
+    // narrowing into a variant of other alternatives, false and out untouched when it cannot hold the current one
+    template <typename W>
+    typename std::enable_if<detail::vrnt::is_variant<W>::value, bool>::type try_narrow(W& out) const&
+    {
+      return detail::vrnt::Convert(out, *this);
+    }
+
+    template <typename W>
+    typename std::enable_if<detail::vrnt::is_variant<W>::value, bool>::type try_narrow(W& out) &&
+    {
+      return detail::vrnt::Convert(out, std::move(*this));
+    }
+
+    // as above, valueless when W cannot hold the current alternative
+    template <typename W>
+    typename std::enable_if<detail::vrnt::is_variant<W>::value, W>::type try_narrow() const&
+    {
+      W out;
+      detail::vrnt::Convert(out, *this);
+      return out;
+    }
+
+    template <typename W>
+    typename std::enable_if<detail::vrnt::is_variant<W>::value, W>::type try_narrow() &&
+    {
+      W out;
+      detail::vrnt::Convert(out, std::move(*this));
+      return out;
+    }
+
+  };
+
+#if OWS_SMOKE_TEST && !OWS_VARIANT_PACKED_TAG
+  static_assert(2 == sizeof(OWS::Variant<char, bool>),          "variant: smallest index type failure");
+  static_assert(4 == sizeof(OWS::Variant<char, short>),         "variant: smallest index type failure");
+  static_assert(8 == sizeof(OWS::Variant<int, float>),          "variant: smallest index type failure");
+  static_assert(2 * sizeof(double) == sizeof(OWS::Variant<double, char>), "variant: smallest index type failure");
+  static_assert(2 * sizeof(void*) == sizeof(OWS::Variant<int, OWS::Boxed<char[256]>>), "variant: boxed alternative failure");
+#endif // OWS_SMOKE_TEST
+
+#if OWS_SMOKE_TEST && !OWS_VARIANT_PACKED_TAG && !OWS_VARIANT_STATS && OWS_VARIANT_CONSTEXPR_MAX >= 2
+  namespace detail
+  {
+    namespace vrnt
+    {
+      constexpr OWS::Variant<int, double> s_SmokeConstexpr{ 7 };
+      constexpr OWS::Variant<int, double> s_SmokeInPlace{ OWS::in_place_index<1>, 2.5 };
+    }
+  }
+
+  static_assert(2.5 == OWS::detail::vrnt::s_SmokeInPlace.get<double>(),                "variant: constexpr in place failure");
+
+  static_assert(0 == OWS::detail::vrnt::s_SmokeConstexpr.index(),                      "variant: constexpr index failure");
+  static_assert(7 == OWS::detail::vrnt::s_SmokeConstexpr.get<int>(),                   "variant: constexpr get failure");
+  static_assert(nullptr == OWS::detail::vrnt::s_SmokeConstexpr.get_if<double>(),       "variant: constexpr get_if failure");
+#endif // OWS_SMOKE_TEST
+
+#if OWS_SMOKE_TEST
+  static_assert(true  == std::is_trivially_copyable<OWS::Variant<int, float, double>>::value,          "variant: trivial copy failure");
+  static_assert(true  == std::is_trivially_destructible<OWS::Variant<int, float, double>>::value,      "variant: trivial destructor failure");
+  static_assert(true  == std::is_trivially_copy_constructible<OWS::Variant<int, float, double>>::value, "variant: trivial copy failure");
+  static_assert(true  == std::is_trivially_move_assignable<OWS::Variant<int, float, double>>::value,   "variant: trivial move failure");
+  static_assert(false == std::is_trivially_copyable<OWS::Variant<int, std::string>>::value,            "variant: trivial copy failure");
+  static_assert(false == std::is_trivially_destructible<OWS::Variant<int, std::string>>::value,        "variant: trivial destructor failure");
+  static_assert(std::is_nothrow_move_constructible<std::string>::value == std::is_nothrow_move_constructible<OWS::Variant<int, std::string>>::value, "variant: move constructor failure");
+  static_assert(true  == std::is_nothrow_move_assignable<OWS::Variant<int, std::string>>::value,       "variant: move assignment failure");
+  static_assert(false == std::is_nothrow_assignable<OWS::Variant<int, std::string>&, std::string const&>::value, "variant: value assignment failure");
+  static_assert(true  == std::is_nothrow_assignable<OWS::Variant<int, std::string>&, int>::value,      "variant: value assignment failure");
+  static_assert(true  == std::is_constructible<OWS::Variant<int, std::string>, OWS::in_place_type_t<std::string>, char const*, size_t>::value, "variant: in place failure");
+  static_assert(false == std::is_constructible<OWS::Variant<int, std::string>, OWS::in_place_type_t<float>>::value,                     "variant: in place failure");
+#endif // OWS_SMOKE_TEST
+
+#if OWS_SMOKE_TEST && !OWS_VARIANT_NEVER_VALUELESS
+  namespace detail
+  {
+    namespace vrnt
+    {
+      struct SmokeThrowingMove
+      {
+        SmokeThrowingMove() = default;
+        SmokeThrowingMove(SmokeThrowingMove const&) = default;
+        SmokeThrowingMove(SmokeThrowingMove&&) noexcept(false) {}
+        SmokeThrowingMove& operator=(SmokeThrowingMove const&) = default;
+        SmokeThrowingMove& operator=(SmokeThrowingMove&&) noexcept(false) { return *this; }
+      };
+    }
+  }
+
+  static_assert(false == std::is_nothrow_move_constructible<OWS::Variant<int, OWS::detail::vrnt::SmokeThrowingMove>>::value, "variant: move constructor failure");
+  static_assert(false == std::is_nothrow_move_assignable<OWS::Variant<int, OWS::detail::vrnt::SmokeThrowingMove>>::value,    "variant: move assignment failure");
+  static_assert(false == std::is_nothrow_assignable<OWS::Variant<int, OWS::detail::vrnt::SmokeThrowingMove>&, OWS::detail::vrnt::SmokeThrowingMove>::value, "variant: value assignment failure");
+#endif // OWS_SMOKE_TEST
+
+  // ***************************************************************************
+  // **************************************************************** visit ****
+
+  // expected hot alternatives, most frequent first, for one visit call or a whole variant type
+  template <size_t... Is>
+  struct hot_alternatives{};
+
+  // Specialize for a variant type to route its single variant visits through the hot alternatives first,
+  // e.g. template <> struct variant_hot_alternatives<Message> : public hot_alternatives<0>{};
+  // OWS_VARIANT_STATS builds can write these specializations with variant_hint_header.
+  template <typename V>
+  struct variant_hot_alternatives : public hot_alternatives<>{};
+
+  namespace detail
+  {
+    namespace vrnt
+    {
+      template <size_t... Is>
+      index_sequence<Is...> HotSequence(hot_alternatives<Is...> const*);
+
+      // hints of a single visited variant, none for several
+      template <typename... Vs>
+      struct HotOf : public type_identity<index_sequence<>>{};
+
+      template <typename V>
+      struct HotOf<V> : public type_identity<decltype(HotSequence(static_cast<variant_hot_alternatives<typename remove_cvref<V>::type>*>(nullptr)))>{};
+
+      struct Access
+      {
+        // storage of every alternative, at the same address whichever is held
+        template <typename... Ts>
+        static void const* raw(Variant<Ts...> const& v) noexcept { return &v.m_Raw; }
+
+        template <typename... Ts>
+        static void* raw(Variant<Ts...>& v) noexcept { return &v.m_Raw; }
+
+        // index of a trivially copyable variant whose storage was just written raw
+        template <typename... Ts>
+        static void set_index(Variant<Ts...>& v, size_t idx) noexcept { v.m_Idx = static_cast<decltype(v.m_Idx)>(idx); }
+
+        template <typename... Ts>
+        static void reset(Variant<Ts...>& v) noexcept { v.TReset(); }
+
+        // Ith alternative as stored, boxes included, carrying the value category of V
+        template <size_t I, typename V, typename W = typename remove_cvref<V>::type>
+        static typename copy_cvref<V&&, typename W::template StoredAt<I>>::type stored(V&& v) noexcept
+        {
+          return static_cast<typename copy_cvref<V&&, typename W::template StoredAt<I>>::type>(v.template TRef<typename W::template StoredAt<I>>());
+        }
+
+        // Ith alternative as seen by users, unboxed
+        template <size_t I, typename V, typename W = typename remove_cvref<V>::type>
+        static typename copy_cvref<V&&, typename W::template AltAt<I>::type>::type get(V&& v) noexcept
+        {
+          using A = typename W::template AltAt<I>;
+          return static_cast<typename copy_cvref<V&&, typename A::type>::type>(A::get(v.template TRef<typename W::template StoredAt<I>>()));
+        }
+      };
+
+      // all same type preserves references, otherwise std::common_type
+      template <typename R, typename... Rs>
+      struct CommonResult : public std::conditional<is_all<R, R, Rs...>::value, type_identity<R>, std::common_type<R, Rs...>>::type{};
+
+      template <size_t... Ns>
+      struct Product : public std::integral_constant<size_t, 1>{};
+
+      template <size_t N, size_t... Ns>
+      struct Product<N, Ns...> : public std::integral_constant<size_t, N * Product<Ns...>::value>{};
+
+      template <typename V, typename W = typename remove_cvref<V>::type>
+      struct VariantSize;
+
+      template <typename V, typename... Ts>
+      struct VariantSize<V, Variant<Ts...>> : public std::integral_constant<size_t, sizeof...(Ts)>{};
+
+      template <size_t I, typename V, typename W = typename remove_cvref<V>::type>
+      struct VariantAlt;
+
+      template <size_t I, typename V, typename... Ts>
+      struct VariantAlt<I, V, Variant<Ts...>> : public Unbox<typename Stored<typename IthType<I, Ts...>::type>::type>{};
+
+      // flattened index stride of the Jth variant, row major
+      template <size_t J, typename V, typename... Vs>
+      struct VisitStride : public VisitStride<J - 1, Vs...>{};
+
+      template <typename V, typename... Vs>
+      struct VisitStride<0, V, Vs...> : public Product<VariantSize<Vs>::value...>{};
+
+      // alternative index of the Jth variant in flattened combination K
+      template <size_t K, size_t J, typename... Vs>
+      struct VisitIndex : public std::integral_constant<size_t, K / VisitStride<J, Vs...>::value % VariantSize<typename IthType<J, Vs...>::type>::value>{};
+
+      template <typename F, size_t K, typename Js, typename... Vs>
+      struct VisitAt;
+
+      template <typename F, size_t K, size_t... Js, typename... Vs>
+      struct VisitAt<F, K, index_sequence<Js...>, Vs...>
+      {
+        using type = decltype(std::declval<F>()(std::declval<typename copy_cvref<Vs&&, typename VariantAlt<VisitIndex<K, Js, Vs...>::value, Vs>::type>::type>()...));
+      };
+
+      template <typename F, typename Ks, typename Js, typename... Vs>
+      struct VisitResultImpl;
+
+      template <typename F, size_t... Ks, typename Js, typename... Vs>
+      struct VisitResultImpl<F, index_sequence<Ks...>, Js, Vs...> : public CommonResult<typename VisitAt<F, Ks, Js, Vs...>::type...>{};
+
+      // common result over every alternative combination
+      template <typename F, typename... Vs>
+      struct VisitResult : public VisitResultImpl<F,
+        typename make_index_sequence<Product<VariantSize<Vs>::value...>::value>::type,
+        typename make_index_sequence<sizeof...(Vs)>::type, Vs...>{};
+
+      // result only computed for variant arguments, so other visit overloads stay viable
+      template <bool AllVariants, typename F, typename... Vs>
+      struct EnableVisit{};
+
+      template <typename F, typename... Vs>
+      struct EnableVisit<true, F, Vs...> : public VisitResult<F, Vs...>{};
+
+      template <typename R, typename F, typename Js, typename... Vs>
+      struct VisitOp;
+
+      // every alternative combination of Vs is one entry of a single flattened dispatch
+      template <typename R, typename F, size_t... Js, typename... Vs>
+      struct VisitOp<R, F, index_sequence<Js...>, Vs...>
+      {
+        using result_type = R;
+        using fnptr_type = R (*)(F&&, Vs&&...);
+        static constexpr size_t s_Count{ Product<VariantSize<Vs>::value...>::value };
+
+        template <size_t K>
+        static R call(F&& f, Vs&&... vs)
+        {
+          return std::forward<F>(f)(Access::get<VisitIndex<K, Js, Vs...>::value>(std::forward<Vs>(vs))...);
+        }
+      };
+
+      template <typename V>
+      inline size_t FlatIndex(V const& v) noexcept { return v.index(); }
+
+      template <typename V, typename... Vs>
+      inline size_t FlatIndex(V const& v, Vs const&... vs) noexcept
+      {
+        return v.index() * Product<VariantSize<Vs>::value...>::value + FlatIndex(vs...);
+      }
+
+      inline bool AnyValueless() noexcept { return false; }
+
+      template <typename V, typename... Vs>
+      inline bool AnyValueless(V const& v, Vs const&... vs) noexcept { return v.valueless() || AnyValueless(vs...); }
+    }
+  }
+
+  // visit one or more variants, every alternative combination costs a single dispatch, hot alternatives of a single
+  // variant's variant_hot_alternatives are tested first
+  template <typename F, typename V, typename... Vs>
+  inline auto visit(F&& f, V&& v, Vs&&... vs) -> typename detail::vrnt::EnableVisit<
+    detail::vrnt::is_all<std::true_type, typename detail::vrnt::is_variant<typename detail::vrnt::remove_cvref<V>::type>::type, typename detail::vrnt::is_variant<typename detail::vrnt::remove_cvref<Vs>::type>::type...>::value,
+    F, V, Vs...>::type
+  {
+    using R = typename detail::vrnt::VisitResult<F, V, Vs...>::type;
+    using Op = detail::vrnt::VisitOp<R, F, typename detail::vrnt::make_index_sequence<1 + sizeof...(Vs)>::type, V, Vs...>;
+    OWS_VRNT_STAT(detail::vrnt::Visited(v, vs...);)
+    if (detail::vrnt::AnyValueless(v, vs...))detail::vrnt::BadAccess("visit on valueless variant");
+    return detail::vrnt::DispatchHot<Op>(typename detail::vrnt::HotOf<V, Vs...>::type{}, detail::vrnt::FlatIndex(v, vs...),
+      std::forward<F>(f), std::forward<V>(v), std::forward<Vs>(vs)...);
+  }
+
+  // as above with this call's hot alternatives, which replace the type's; for several variants Is are flattened
+  // combination indices, row major, e.g. (i, j) of Variant<A, B> and Variant<C, D, E> is i * 3 + j
+  template <size_t... Is, typename F, typename V, typename... Vs>
+  inline auto visit(hot_alternatives<Is...>, F&& f, V&& v, Vs&&... vs) -> typename detail::vrnt::EnableVisit<
+    detail::vrnt::is_all<std::true_type, typename detail::vrnt::is_variant<typename detail::vrnt::remove_cvref<V>::type>::type, typename detail::vrnt::is_variant<typename detail::vrnt::remove_cvref<Vs>::type>::type...>::value,
+    F, V, Vs...>::type
+  {
+    using R = typename detail::vrnt::VisitResult<F, V, Vs...>::type;
+    using Op = detail::vrnt::VisitOp<R, F, typename detail::vrnt::make_index_sequence<1 + sizeof...(Vs)>::type, V, Vs...>;
+    OWS_VRNT_STAT(detail::vrnt::Visited(v, vs...);)
+    if (detail::vrnt::AnyValueless(v, vs...))detail::vrnt::BadAccess("visit on valueless variant");
+    return detail::vrnt::DispatchHot<Op>(detail::vrnt::index_sequence<Is...>{}, detail::vrnt::FlatIndex(v, vs...),
+      std::forward<F>(f), std::forward<V>(v), std::forward<Vs>(vs)...);
+  }
+
+#if OWS_SMOKE_TEST
+  namespace detail
+  {
+    namespace vrnt
+    {
+      struct SmokeVisitor
+      {
+        int operator()(int) const { return 0; }
+        long operator()(char) const { return 0; }
+        template <typename T>
+        T&& operator()(T&& t) const { return std::forward<T>(t); }
+      };
+
+      struct SmokeVoidVisitor
+      {
+        template <typename T>
+        void operator()(T const&) const {}
+      };
+
+      struct SmokeMultiVisitor
+      {
+        int operator()(int, int) const { return 0; }
+        template <typename T, typename U>
+        double operator()(T const&, U const&) const { return 0; }
+      };
+    }
+  }
+
+  static_assert(true == std::is_same<long,         decltype(OWS::visit(OWS::detail::vrnt::SmokeVisitor{}, std::declval<OWS::Variant<int, char>&>()))>::value,       "visit: common type result failure");
+  static_assert(true == std::is_same<float&,       decltype(OWS::visit(OWS::detail::vrnt::SmokeVisitor{}, std::declval<OWS::Variant<float>&>()))>::value,          "visit: reference result failure");
+  static_assert(true == std::is_same<float const&, decltype(OWS::visit(OWS::detail::vrnt::SmokeVisitor{}, std::declval<OWS::Variant<float> const&>()))>::value,    "visit: const reference result failure");
+  static_assert(true == std::is_same<float&&,      decltype(OWS::visit(OWS::detail::vrnt::SmokeVisitor{}, std::declval<OWS::Variant<float>>()))>::value,           "visit: rvalue result failure");
+  static_assert(true == std::is_same<void,         decltype(OWS::visit(OWS::detail::vrnt::SmokeVoidVisitor{}, std::declval<OWS::Variant<float, double>&>()))>::value, "visit: void result failure");
+  static_assert(true == std::is_same<double,       decltype(OWS::visit(OWS::detail::vrnt::SmokeMultiVisitor{}, std::declval<OWS::Variant<int, char>&>(), std::declval<OWS::Variant<int> const&>()))>::value, "visit: multi variant result failure");
+  static_assert(6 == OWS::detail::vrnt::VisitOp<void, OWS::detail::vrnt::SmokeVoidVisitor, OWS::detail::vrnt::index_sequence<0, 1>, OWS::Variant<int, char>&, OWS::Variant<int, char, float>&>::s_Count, "visit: multi variant flattening failure");
+  static_assert(2 == OWS::detail::vrnt::VisitIndex<5, 1, OWS::Variant<int, char>&, OWS::Variant<int, char, float>&>::value, "visit: multi variant flattening failure");
+  static_assert(1 == OWS::detail::vrnt::VisitIndex<5, 0, OWS::Variant<int, char>&, OWS::Variant<int, char, float>&>::value, "visit: multi variant flattening failure");
+#endif // OWS_SMOKE_TEST
+
+  // **************************************************************** visit ****
+  // ***************************************************************************
+
+  // ***************************************************************************
+  // ***************************************************************** hash ****
+
+  namespace detail
+  {
+    namespace vrnt
+    {
+      static constexpr std::uint64_t s_HashK1{ 0x9e3779b185ebca87ull };
+      static constexpr std::uint64_t s_HashK2{ 0xc2b2ae3d27d4eb4full };
+      static constexpr std::uint64_t s_ValuelessHash{ 0x2545f4914f6cdd1dull };
+
+      inline std::uint64_t HashRotl(std::uint64_t x, unsigned r) noexcept { return (x << r) | (x >> (64 - r)); }
+
+      inline std::uint64_t HashFinal(std::uint64_t h) noexcept
+      {
+        h ^= h >> 33;
+        h *= 0xff51afd7ed558ccdull;
+        h ^= h >> 33;
+        h *= 0xc4ceb9fe1a85ec53ull;
+        return h ^ (h >> 33);
+      }
+
+      inline std::uint64_t HashRound(std::uint64_t lane, std::uint64_t word) noexcept { return HashRotl(lane + word * s_HashK2, 31) * s_HashK1; }
+
+      inline std::uint64_t LoadWord(unsigned char const* p) noexcept
+      {
+        std::uint64_t word;
+        std::memcpy(&word, p, sizeof(word));
+        return word;
+      }
+
+      // four independent lanes over 32 byte blocks, then words and a zero padded tail
+      inline std::uint64_t HashBytes(unsigned char const* p, size_t n, std::uint64_t seed) noexcept
+      {
+        std::uint64_t h{ seed ^ (n * s_HashK1) };
+        size_t i{ 0 };
+        if (n >= 32)
+        {
+          std::uint64_t lanes[4]{ h + s_HashK1, h + s_HashK2, h, h - s_HashK1 };
+          for (; i + 32 <= n; i += 32)
+            for (size_t l{ 0 }; l < 4; ++l)lanes[l] = HashRound(lanes[l], LoadWord(p + i + 8 * l));
+          h = HashRotl(lanes[0], 1) + HashRotl(lanes[1], 7) + HashRotl(lanes[2], 12) + HashRotl(lanes[3], 18);
+        }
+        for (; i + 8 <= n; i += 8)h = HashRound(h, LoadWord(p + i));
+        if (i < n)
+        {
+          unsigned char tail[8]{};
+          std::memcpy(tail, p + i, n - i);
+          h = HashRound(h, LoadWord(tail));
+        }
+        return HashFinal(h);
+      }
+
+      // small storage hashed as a fixed run of words with the bytes past the held alternative masked off,
+      // straight line code whichever alternative is held, larger storage hashes only the held alternative's bytes
+      static constexpr size_t s_HashFixedMax{ 32 };
+
+      template <size_t Raw>
+      inline std::uint64_t LoadWordAt(unsigned char const* p, size_t w) noexcept
+      {
+        if (8 * w + 8 <= Raw)return LoadWord(p + 8 * w);
+        std::uint64_t word{ 0 };
+        std::memcpy(&word, p + 8 * w, Raw - 8 * w);
+        return word;
+      }
+
+      // bytes of word w that lie within the first n bytes
+      inline std::uint64_t WordMask(size_t n, size_t w) noexcept
+      {
+        size_t const valid{ n > 8 * w ? n - 8 * w : 0 };
+        return valid >= 8 ? ~std::uint64_t{ 0 } : ~(~std::uint64_t{ 0 } << (8 * valid));
+      }
+
+      template <size_t Raw>
+      inline std::uint64_t HashStorage(std::true_type /* fixed */, unsigned char const* p, size_t n, std::uint64_t seed) noexcept
+      {
+        std::uint64_t h{ seed };
+        for (size_t w{ 0 }; w < (Raw + 7) / 8; ++w)
+        {
+          h = HashRound(h, LoadWordAt<Raw>(p, w) & WordMask(n, w));
+        }
+        return HashFinal(h);
+      }
+
+      template <size_t Raw>
+      inline std::uint64_t HashStorage(std::false_type /* by length */, unsigned char const* p, size_t n, std::uint64_t seed) noexcept
+      {
+        return HashBytes(p, n, seed);
+      }
+
+      // idx is a constant in each dispatch entry, the mix folds to a single xor
+      inline size_t HashMix(size_t hash, size_t idx) noexcept
+      {
+        return hash ^ static_cast<size_t>((idx + 1) * s_HashK1);
+      }
+
+      template <typename V>
+      struct HashOp
+      {
+        using result_type = size_t;
+        using fnptr_type = size_t (*)(V const*);
+        static constexpr size_t s_Count{ VariantSize<V>::value };
+
+        template <size_t I, typename T = typename remove_cvref<decltype(Access::get<I>(std::declval<V const&>()))>::type>
+        static size_t call(V const* v) { return HashMix(std::hash<T>{}(Access::get<I>(*v)), I); }
+      };
+
+      template <typename... Ts>
+      struct AltSizes : public CTValues<size_t, sizeof(Ts)...>{};
+    }
+  }
+
+  // std::hash of the held alternative mixed with its index, one dispatch, also found by ADL as boost::hash does
+  template <typename... Ts>
+  inline size_t hash_value(Variant<Ts...> const& v)
+  {
+    using V = Variant<Ts...>;
+    return v.valueless() ? static_cast<size_t>(detail::vrnt::s_ValuelessHash) : detail::vrnt::Dispatch<detail::vrnt::HashOp<V>>(v.index(), &v);
+  }
+
+  // Trivially copyable alternatives hashed straight from storage, no dispatch, only a table of alternative sizes.
+  // Equal values must have equal bytes, so alternatives with padding or floating point members (0.0 and -0.0) are unsuitable.
+  template <typename... Ts>
+  inline size_t hash_bytes(Variant<Ts...> const& v) noexcept
+  {
+    static_assert(true == std::is_trivially_copyable<Variant<Ts...>>::value, "hash_bytes alternatives should be trivially copyable");
+    if (v.valueless())return static_cast<size_t>(detail::vrnt::s_ValuelessHash);
+    static constexpr size_t s_Raw{ detail::vrnt::RawSize<Ts...>::value };
+    return static_cast<size_t>(detail::vrnt::HashStorage<s_Raw>(std::integral_constant<bool, s_Raw <= detail::vrnt::s_HashFixedMax>{},
+      static_cast<unsigned char const*>(detail::vrnt::Access::raw(v)), detail::vrnt::AltSizes<Ts...>::s_Values[v.index()], (v.index() + 1) * detail::vrnt::s_HashK2));
+  }
+
+  // hasher for unordered containers keyed on variants, see hash_bytes
+  struct variant_bytes_hash
+  {
+    template <typename... Ts>
+    size_t operator()(Variant<Ts...> const& v) const noexcept { return hash_bytes(v); }
+  };
+
+#if OWS_SMOKE_TEST
+  static_assert(true == std::is_same<size_t, decltype(std::declval<OWS::variant_bytes_hash const&>()(std::declval<OWS::Variant<int, char> const&>()))>::value, "hash: bytes hasher failure");
+  static_assert(8 == OWS::detail::vrnt::AltSizes<int, double, char>::s_Values[1], "hash: size table failure");
+#endif // OWS_SMOKE_TEST
+
+  // ***************************************************************** hash ****
+  // ***************************************************************************
+
+  // ***************************************************************************
+  // ************************************************************** compare ****
+
+  // Alternatives whose == is exactly byte equality over sizeof(T), letting Variant equality skip dispatch.
+  // Integers, enums and pointers qualify; specialize as true_type for padding free structs with memberwise ==.
+  template <typename T>
+  struct trivially_equality_comparable : public std::integral_constant<bool,
+    std::is_integral<T>::value || std::is_enum<T>::value || std::is_pointer<T>::value>{};
+
+  namespace detail
+  {
+    namespace vrnt
+    {
+      struct EqualTo      { template <typename T> bool operator()(T const& l, T const& r) const { return l == r; } };
+      struct NotEqualTo   { template <typename T> bool operator()(T const& l, T const& r) const { return l != r; } };
+      struct Less         { template <typename T> bool operator()(T const& l, T const& r) const { return l < r; } };
+      struct Greater      { template <typename T> bool operator()(T const& l, T const& r) const { return l > r; } };
+      struct LessEqual    { template <typename T> bool operator()(T const& l, T const& r) const { return l <= r; } };
+      struct GreaterEqual { template <typename T> bool operator()(T const& l, T const& r) const { return l >= r; } };
+
+      // payloads of two variants holding the same alternative
+      template <typename V, typename Cmp>
+      struct CompareOp
+      {
+        using result_type = bool;
+        using fnptr_type = bool (*)(V const*, V const*);
+        static constexpr size_t s_Count{ VariantSize<V>::value };
+
+        template <size_t I>
+        static bool call(V const* l, V const* r) { return Cmp{}(Access::get<I>(*l), Access::get<I>(*r)); }
+      };
+
+      template <typename Cmp, typename V>
+      inline bool Compare(V const& l, V const& r) { return Dispatch<CompareOp<V, Cmp>>(l.index(), &l, &r); }
+
+      template <size_t Raw>
+      inline bool BytesEqual(std::true_type /* fixed */, unsigned char const* l, unsigned char const* r, size_t n) noexcept
+      {
+        std::uint64_t diff{ 0 };
+        for (size_t w{ 0 }; w < (Raw + 7) / 8; ++w)diff |= (LoadWordAt<Raw>(l, w) ^ LoadWordAt<Raw>(r, w)) & WordMask(n, w);
+        return 0 == diff;
+      }
+
+      template <size_t Raw>
+      inline bool BytesEqual(std::false_type /* by length */, unsigned char const* l, unsigned char const* r, size_t n) noexcept
+      {
+        return 0 == std::memcmp(l, r, n);
+      }
+
+      // payload equality of two variants holding the same alternative
+      template <typename... Ts>
+      inline bool PayloadEqual(std::true_type /* bytes */, Variant<Ts...> const& l, Variant<Ts...> const& r) noexcept
+      {
+        static constexpr size_t s_Raw{ RawSize<Ts...>::value };
+        return BytesEqual<s_Raw>(std::integral_constant<bool, s_Raw <= s_HashFixedMax>{}, static_cast<unsigned char const*>(Access::raw(l)),
+          static_cast<unsigned char const*>(Access::raw(r)), AltSizes<Ts...>::s_Values[l.index()]);
+      }
+
+      template <typename... Ts>
+      inline bool PayloadEqual(std::false_type /* dispatch */, Variant<Ts...> const& l, Variant<Ts...> const& r)
+      {
+        return Compare<EqualTo>(l, r);
+      }
+
+      template <typename... Ts>
+      inline bool PayloadNotEqual(std::true_type /* bytes */, Variant<Ts...> const& l, Variant<Ts...> const& r) noexcept
+      {
+        return !PayloadEqual(std::true_type{}, l, r);
+      }
+
+      template <typename... Ts>
+      inline bool PayloadNotEqual(std::false_type /* dispatch */, Variant<Ts...> const& l, Variant<Ts...> const& r)
+      {
+        return Compare<NotEqualTo>(l, r);
+      }
+
+      template <typename... Ts>
+      struct BytesComparable : public std::integral_constant<bool,
+        all_true<trivially_equality_comparable<Ts>::value...>::value && std::is_trivially_copyable<Variant<Ts...>>::value>{};
+    }
+  }
+
+  // std::variant semantics, indices first (valueless before every alternative), then one dispatch on the payloads
+
+  template <typename... Ts>
+  inline bool operator==(Variant<Ts...> const& l, Variant<Ts...> const& r)
+  {
+    if (l.index() != r.index())return false;
+    return l.valueless() || detail::vrnt::PayloadEqual(detail::vrnt::BytesComparable<Ts...>{}, l, r);
+  }
+
+  template <typename... Ts>
+  inline bool operator!=(Variant<Ts...> const& l, Variant<Ts...> const& r)
+  {
+    if (l.index() != r.index())return true;
+    if (l.valueless())return false;
+    return detail::vrnt::PayloadNotEqual(detail::vrnt::BytesComparable<Ts...>{}, l, r);
+  }
+
+  template <typename... Ts>
+  inline bool operator<(Variant<Ts...> const& l, Variant<Ts...> const& r)
+  {
+    if (r.valueless())return false;
+    if (l.valueless())return true;
+    if (l.index() != r.index())return l.index() < r.index();
+    return detail::vrnt::Compare<detail::vrnt::Less>(l, r);
+  }
+
+  template <typename... Ts>
+  inline bool operator>(Variant<Ts...> const& l, Variant<Ts...> const& r)
+  {
+    if (l.valueless())return false;
+    if (r.valueless())return true;
+    if (l.index() != r.index())return l.index() > r.index();
+    return detail::vrnt::Compare<detail::vrnt::Greater>(l, r);
+  }
+
+  template <typename... Ts>
+  inline bool operator<=(Variant<Ts...> const& l, Variant<Ts...> const& r)
+  {
+    if (l.valueless())return true;
+    if (r.valueless())return false;
+    if (l.index() != r.index())return l.index() < r.index();
+    return detail::vrnt::Compare<detail::vrnt::LessEqual>(l, r);
+  }
+
+  template <typename... Ts>
+  inline bool operator>=(Variant<Ts...> const& l, Variant<Ts...> const& r)
+  {
+    if (r.valueless())return true;
+    if (l.valueless())return false;
+    if (l.index() != r.index())return l.index() > r.index();
+    return detail::vrnt::Compare<detail::vrnt::GreaterEqual>(l, r);
+  }
+
+#if OWS_SMOKE_TEST
+  static_assert(true  == OWS::detail::vrnt::BytesComparable<int, char, long*>::value, "compare: bytes equality failure");
+  static_assert(false == OWS::detail::vrnt::BytesComparable<int, float>::value,       "compare: bytes equality failure");
+  static_assert(false == OWS::detail::vrnt::BytesComparable<int, std::string>::value, "compare: bytes equality failure");
+#endif // OWS_SMOKE_TEST
+
+  // ************************************************************** compare ****
+  // ***************************************************************************
+
+  // ***************************************************************************
+  // ************************************************************** convert ****
+
+  namespace detail
+  {
+    namespace vrnt
+    {
+      static constexpr size_t s_NoIndex{ std::numeric_limits<size_t>::max() };
+
+      template <bool Found, typename R, typename... Ts>
+      struct IndexOrNoneImpl : public std::integral_constant<size_t, s_NoIndex>{};
+
+      template <typename R, typename... Ts>
+      struct IndexOrNoneImpl<true, R, Ts...> : public IFromType<0, R, Ts...>{};
+
+      // index of R among Ts, s_NoIndex when absent
+      template <typename R, typename... Ts>
+      struct IndexOrNone : public IndexOrNoneImpl<is_any<R, Ts...>::value, R, Ts...>{};
+
+      template <typename To, typename From>
+      struct Remap;
+
+      // destination index of every source alternative, matched by declared type so boxes carry over
+      template <typename... Ts, typename... Us>
+      struct Remap<Variant<Ts...>, Variant<Us...>> : public CTValues<size_t, IndexOrNone<Us, Ts...>::value...>
+      {
+        static constexpr bool s_Total{ all_true<(s_NoIndex != IndexOrNone<Us, Ts...>::value)...>::value };
+        static constexpr bool s_Relocate{ std::is_trivially_copyable<Variant<Ts...>>::value && std::is_trivially_copyable<Variant<Us...>>::value };
+      };
+
+      template <typename From, typename To>
+      struct is_subset : public std::false_type{};
+
+      template <typename... Us, typename... Ts>
+      struct is_subset<Variant<Us...>, Variant<Ts...>> : public std::integral_constant<bool,
+        !std::is_same<Variant<Us...>, Variant<Ts...>>::value && Remap<Variant<Ts...>, Variant<Us...>>::s_Total>{};
+
+      // Us deduced empty, e.g. from a bare in_place_type<T> argument, Variant<> is never instantiated
+      template <typename... Ts>
+      struct is_subset<Variant<>, Variant<Ts...>> : public std::false_type{};
+
+      // one dispatch on the source index, the stored alternative is moved or copied to its remapped index
+      template <typename To, typename From, typename W = typename remove_cvref<From>::type>
+      struct ConvertOp
+      {
+        using result_type = bool;
+        using fnptr_type = bool (*)(To*, typename std::remove_reference<From>::type*);
+        static constexpr size_t s_Count{ VariantSize<W>::value };
+
+        template <size_t I>
+        static bool call(To* to, typename std::remove_reference<From>::type* from)
+        {
+          return Emplace<I>(index_constant<Remap<To, W>::s_Values[I]>{}, to, from);
+        }
+
+        template <size_t I>
+        static bool Emplace(index_constant<s_NoIndex>, To*, typename std::remove_reference<From>::type*) { return false; }
+
+        template <size_t I, size_t J>
+        static bool Emplace(index_constant<J>, To* to, typename std::remove_reference<From>::type* from)
+        {
+          to->template emplace<J>(Access::stored<I>(std::forward<From>(*from)));
+          Vacate<I>(from);
+          return true;
+        }
+
+        // a box moved to the other variant leaves from valueless
+        template <size_t I>
+        static void Vacate(W const*) noexcept {}
+
+        template <size_t I>
+        static void Vacate(W* from) noexcept { if (MovedOut(Access::stored<I>(*from)))Access::reset(*from); }
+      };
+
+      // trivially copyable on both sides, one lookup and one copy of the held alternative's bytes
+      template <typename... Ts, typename... Us>
+      inline bool ConvertAs(std::true_type /* relocate */, Variant<Ts...>& to, Variant<Us...> const& from) noexcept
+      {
+        using Map = Remap<Variant<Ts...>, Variant<Us...>>;
+        if (from.valueless())
+        {
+          to = Variant<Ts...>{};
+          return true;
+        }
+        size_t const idx{ Map::s_Values[from.index()] };
+        if (s_NoIndex == idx)return false;
+        std::memcpy(Access::raw(to), Access::raw(from), AltSizes<Us...>::s_Values[from.index()]);
+        Access::set_index(to, idx);
+        return true;
+      }
+
+      template <typename To, typename From>
+      inline bool ConvertAs(std::false_type /* dispatch */, To& to, From&& from)
+      {
+        if (from.valueless())
+        {
+          to = To{};
+          return true;
+        }
+        return Dispatch<ConvertOp<To, From&&>>(from.index(), &to, &from);
+      }
+
+      template <typename To, typename From>
+      bool Convert(To& to, From&& from)
+      {
+        return ConvertAs(std::integral_constant<bool, Remap<To, typename remove_cvref<From>::type>::s_Relocate>{}, to, std::forward<From>(from));
+      }
+    }
+  }
+
+#if OWS_SMOKE_TEST
+  static_assert(2 == OWS::detail::vrnt::Remap<OWS::Variant<int, char, float>, OWS::Variant<float, int>>::s_Values[0] &&
+                0 == OWS::detail::vrnt::Remap<OWS::Variant<int, char, float>, OWS::Variant<float, int>>::s_Values[1], "convert: remap failure");
+  static_assert(true  == OWS::detail::vrnt::is_subset<OWS::Variant<float, int>, OWS::Variant<int, char, float>>::value, "convert: subset failure");
+  static_assert(false == OWS::detail::vrnt::is_subset<OWS::Variant<float, long>, OWS::Variant<int, char, float>>::value, "convert: subset failure");
+  static_assert(false == OWS::detail::vrnt::is_subset<OWS::Variant<int>, OWS::Variant<int>>::value,                    "convert: subset failure");
+  static_assert(true  == std::is_convertible<OWS::Variant<int>, OWS::Variant<char, int>>::value,                        "convert: widening failure");
+  static_assert(false == std::is_convertible<OWS::Variant<char, int>, OWS::Variant<int>>::value,                        "convert: narrowing failure");
+  // converting constructors must not deduce Variant<> from a bare tag function, checked once they are complete
+  static_assert(sizeof(OWS::Variant<int, std::string>{ OWS::in_place_type<std::string> }) == sizeof(OWS::Variant<int, std::string>), "variant: bare in place tag failure");
+  static_assert(sizeof(OWS::Variant<int, std::string>{ OWS::in_place_index<1> }) == sizeof(OWS::Variant<int, std::string>),          "variant: bare in place tag failure");
+#endif // OWS_SMOKE_TEST
+
+  // ************************************************************** convert ****
+  // ***************************************************************************
+
+  // ***************************************************************************
+  // ***************************************************************** swap ****
+
+  template <typename... Ts>
+  struct is_trivially_relocatable<Variant<Ts...>> : public detail::vrnt::VariantTriviallyRelocatable<typename detail::vrnt::Stored<Ts>::type...>{};
+
+  template <typename... Ts>
+  inline void swap(Variant<Ts...>& lhs, Variant<Ts...>& rhs) noexcept(noexcept(lhs.swap(rhs)))
+  {
+    lhs.swap(rhs);
+  }
+
+  namespace detail
+  {
+    namespace vrnt
+    {
+      template <typename T>
+      inline void RelocateAs(std::true_type /* relocatable */, T* first, size_t count, T* dest) noexcept
+      {
+        if (count)std::memcpy(static_cast<void*>(dest), static_cast<void*>(first), count * sizeof(T));
+      }
+
+      template <typename T>
+      inline void RelocateAs(std::false_type /* move and destroy */, T* first, size_t count, T* dest) noexcept
+      {
+        for (size_t i{ 0 }; i < count; ++i)
+        {
+          ::new (static_cast<void*>(dest + i)) T(std::move(first[i]));
+          first[i].~T();
+        }
+      }
+    }
+  }
+
+  // moves count objects into uninitialized dest and ends them at first, one memcpy for is_trivially_relocatable T
+  template <typename T>
+  inline void uninitialized_relocate(T* first, size_t count, T* dest) noexcept
+  {
+    static_assert(is_trivially_relocatable<T>::value || std::is_nothrow_move_constructible<T>::value, "relocated type should not throw on move");
+    detail::vrnt::RelocateAs(is_trivially_relocatable<T>{}, first, count, dest);
+  }
+
+#if OWS_SMOKE_TEST
+  static_assert(true  == OWS::is_trivially_relocatable<OWS::Variant<int, OWS::Boxed<std::string>>>::value, "swap: relocatable failure");
+  static_assert(false == OWS::is_trivially_relocatable<OWS::Variant<int, std::string>>::value || 0 != OWS_VARIANT_BOX_THRESHOLD, "swap: relocatable failure");
+  static_assert(true  == noexcept(std::declval<OWS::Variant<int, std::string>&>().swap(std::declval<OWS::Variant<int, std::string>&>())), "swap: noexcept failure");
+#endif // OWS_SMOKE_TEST
+
+  // ***************************************************************** swap ****
+  // ***************************************************************************
+}
+
+namespace std
+{
+  template <typename... Ts>
+  struct hash<OWS::Variant<Ts...>>
+  {
+    size_t operator()(OWS::Variant<Ts...> const& v) const { return OWS::hash_value(v); }
+  };
 }
 
 #endif // !HEADER_GUARD_OWS_VARIANT_HPP
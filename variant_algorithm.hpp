@@ -0,0 +1,282 @@
+/*!*****************************************************************************
+ * @file    variant_algorithm.hpp
+ * @author  Owen Huang Wensong
+ * @date    14 OCT 2026
+ * @brief   Batch visitation over ranges of variants for C++11.
+ *
+ * @par     Copyright (c) 2023 Owen Huang Wensong.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+*******************************************************************************/
+
+#ifndef HEADER_GUARD_OWS_VARIANT_ALGORITHM_HPP
+#define HEADER_GUARD_OWS_VARIANT_ALGORITHM_HPP
+
+#include "variant.hpp"
+
+#include <vector>    // bucket scratch, threads
+#include <memory>    // shared job state
+#include <atomic>    // range cursors
+#include <thread>    // std::thread workers
+#include <functional>// executor tasks
+
+namespace OWS
+{
+  // elements grouped by alternative, each alternative's handler runs in its own branch free loop
+  struct bucketed_t{};
+  static constexpr bucketed_t bucketed{};
+
+  // range split across workers, each claims m_Grain elements at a time from its own share then steals from others
+  struct parallel_policy
+  {
+    explicit parallel_policy(unsigned workers = 0, size_t grain = 16384, bool byAlternative = false) noexcept :
+      m_Workers{ workers }, m_Grain{ grain ? grain : 1 }, m_Bucketed{ byAlternative } {}
+
+    unsigned m_Workers; // 0 is std::thread::hardware_concurrency
+    size_t   m_Grain;
+    bool     m_Bucketed;
+  };
+
+  // ***************************************************************************
+  // *************************************************************** detail ****
+
+  namespace detail
+  {
+    namespace valg
+    {
+      // counting sort of element pointers by index, stable within an alternative, scratch reused across calls
+      template <typename V, typename W = typename vrnt::remove_cvref<V>::type>
+      class Buckets
+      {
+        static constexpr size_t s_Count{ vrnt::VariantSize<W>::value };
+
+      public:
+
+        template <typename It>
+        void Fill(It first, It last)
+        {
+          for (size_t& begin : m_Begin)begin = 0;
+          for (It it{ first }; it != last; ++it)
+          {
+            if ((*it).valueless())vrnt::BadAccess("visit on valueless variant");
+            ++m_Begin[1 + (*it).index()];
+          }
+          for (size_t i{ 0 }; i < s_Count; ++i)m_Begin[i + 1] += m_Begin[i];
+
+          size_t next[s_Count];
+          for (size_t i{ 0 }; i < s_Count; ++i)next[i] = m_Begin[i];
+          m_Items.resize(m_Begin[s_Count]);
+          for (It it{ first }; it != last; ++it)m_Items[next[(*it).index()]++] = &*it;
+        }
+
+        template <typename F>
+        void Run(F& f) const { RunAll(f, typename vrnt::make_index_sequence<s_Count>::type{}); }
+
+      private:
+
+        template <typename F, size_t... Is>
+        void RunAll(F& f, vrnt::index_sequence<Is...>) const
+        {
+          int unpack[]{ 0, (RunOne<Is>(f), 0)... };
+          static_cast<void>(unpack);
+        }
+
+        template <size_t I, typename F>
+        void RunOne(F& f) const
+        {
+          for (size_t i{ m_Begin[I] }, end{ m_Begin[I + 1] }; i < end; ++i)f(vrnt::Access::get<I>(*m_Items[i]));
+        }
+
+        std::vector<V*> m_Items;
+        size_t m_Begin[s_Count + 1];
+      };
+
+      template <typename It>
+      using Element = typename std::remove_reference<decltype(*std::declval<It>())>::type;
+
+      // one worker's share of the range, padded rather than aligned as shares are heap allocated before C++17's aligned new
+      struct Share
+      {
+        std::atomic<size_t> m_Next;
+        size_t m_End;
+        char m_Pad[64 - sizeof(std::atomic<size_t>) - sizeof(size_t)];
+      };
+
+      // outlives the call when an executor runs a task late, such a task finds nothing to claim and never touches f
+      template <typename It, typename F>
+      struct Job
+      {
+        Job(It first, size_t total, F const* f, parallel_policy const& policy, unsigned workers) :
+          m_First{ first }, m_F{ f }, m_Grain{ policy.m_Grain }, m_Bucketed{ policy.m_Bucketed },
+          m_Workers{ workers }, m_Total{ total }, m_Shares{ new Share[workers] }
+        {
+          for (unsigned w{ 0 }; w < workers; ++w)
+          {
+            m_Shares[w].m_Next.store(total * w / workers, std::memory_order_relaxed);
+            m_Shares[w].m_End = total * (w + 1) / workers;
+          }
+        }
+
+        void Work(unsigned self)
+        {
+          Buckets<Element<It>> scratch;
+          for (unsigned k{ 0 }; k < m_Workers; ++k)
+          {
+            Share& share{ m_Shares[(self + k) % m_Workers] }; // own share first, then steal
+            for (;;)
+            {
+              size_t const begin{ share.m_Next.fetch_add(m_Grain, std::memory_order_relaxed) };
+              if (begin >= share.m_End)break;
+              size_t const end{ begin + m_Grain < share.m_End ? begin + m_Grain : share.m_End };
+#if OWS_VARIANT_NO_EXCEPTIONS
+              Process(begin, end, scratch);
+#else
+              try { Process(begin, end, scratch); }
+              catch (...) { Fail(); }
+#endif
+              m_Done.fetch_add(end - begin, std::memory_order_acq_rel);
+            }
+          }
+        }
+
+        void Process(size_t begin, size_t end, Buckets<Element<It>>& scratch)
+        {
+          if (m_Bucketed)
+          {
+            scratch.Fill(m_First + begin, m_First + end);
+            scratch.Run(*m_F);
+            return;
+          }
+          for (It it{ m_First + begin }, last{ m_First + end }; it != last; ++it)visit(*m_F, *it);
+        }
+
+#if !OWS_VARIANT_NO_EXCEPTIONS
+        // first exception wins, unclaimed elements are counted done so the caller stops waiting
+        void Fail()
+        {
+          if (!m_Failed.exchange(true, std::memory_order_acq_rel))m_Error = std::current_exception();
+          for (unsigned w{ 0 }; w < m_Workers; ++w)
+          {
+            size_t const next{ m_Shares[w].m_Next.exchange(m_Shares[w].m_End, std::memory_order_relaxed) };
+            if (next < m_Shares[w].m_End)m_Done.fetch_add(m_Shares[w].m_End - next, std::memory_order_acq_rel);
+          }
+        }
+#endif
+
+        void Wait() const
+        {
+          while (m_Done.load(std::memory_order_acquire) < m_Total)std::this_thread::yield();
+        }
+
+        It m_First;
+        F const* m_F;
+        size_t m_Grain;
+        bool m_Bucketed;
+        unsigned m_Workers;
+        size_t m_Total;
+        std::unique_ptr<Share[]> m_Shares;
+        std::atomic<size_t> m_Done{ 0 };
+        std::atomic<bool> m_Failed{ false };
+        std::exception_ptr m_Error;
+      };
+
+      // caller thread works too, returns the first exception thrown by f
+      template <typename Exec, typename It, typename F>
+      std::exception_ptr Parallel(parallel_policy const& policy, Exec& exec, It first, It last, F const& f)
+      {
+        size_t const total{ static_cast<size_t>(last - first) };
+        unsigned workers{ policy.m_Workers ? policy.m_Workers : std::thread::hardware_concurrency() };
+        size_t const chunks{ (total + policy.m_Grain - 1) / policy.m_Grain };
+        if (chunks < workers)workers = static_cast<unsigned>(chunks);
+        if (workers < 1)workers = 1;
+
+        std::shared_ptr<Job<It, F>> const job{ std::make_shared<Job<It, F>>(first, total, &f, policy, workers) };
+#if OWS_VARIANT_NO_EXCEPTIONS
+        for (unsigned w{ 1 }; w < workers; ++w)exec(std::function<void()>{ [job, w]() { job->Work(w); } });
+#else
+        // a failed spawn must not unwind past running tasks, the shares of missing workers are stolen below
+        try { for (unsigned w{ 1 }; w < workers; ++w)exec(std::function<void()>{ [job, w]() { job->Work(w); } }); }
+        catch (...) {}
+#endif
+        job->Work(0);
+        job->Wait();
+        return job->m_Error;
+      }
+
+      inline void Rethrow(std::exception_ptr const& error)
+      {
+#if OWS_VARIANT_NO_EXCEPTIONS
+        static_cast<void>(error);
+#else
+        if (error)std::rethrow_exception(error);
+#endif
+      }
+    }
+  }
+
+  // *************************************************************** detail ****
+  // ***************************************************************************
+
+  // f over every element in order, one dispatch per element
+  template <typename It, typename F>
+  inline typename std::enable_if<detail::vrnt::is_variant<typename detail::vrnt::remove_cvref<decltype(*std::declval<It>())>::type>::value>::type
+    visit_all(It first, It last, F&& f)
+  {
+    for (; first != last; ++first)visit(f, *first);
+  }
+
+  // f over every element grouped by alternative, in alternative order and stable within one, forward iterators
+  template <typename It, typename F>
+  inline typename std::enable_if<detail::vrnt::is_variant<typename detail::vrnt::remove_cvref<decltype(*std::declval<It>())>::type>::value>::type
+    visit_all(bucketed_t, It first, It last, F&& f)
+  {
+    detail::valg::Buckets<detail::valg::Element<It>> buckets;
+    buckets.Fill(first, last);
+    buckets.Run(f);
+  }
+
+  // f over every element from several threads, random access iterators, f is called concurrently
+  // exec(std::function<void()>) runs a task on the caller's pool, the calling thread takes part and returns once every
+  // element is visited, the first exception thrown by f is rethrown after the remaining elements are abandoned
+  template <typename Exec, typename It, typename F>
+  inline typename std::enable_if<detail::vrnt::is_variant<typename detail::vrnt::remove_cvref<decltype(*std::declval<It>())>::type>::value>::type
+    visit_all(parallel_policy const& policy, Exec&& exec, It first, It last, F const& f)
+  {
+    detail::valg::Rethrow(detail::valg::Parallel(policy, exec, first, last, f));
+  }
+
+  // as above on std::threads started for the call
+  template <typename It, typename F>
+  inline typename std::enable_if<detail::vrnt::is_variant<typename detail::vrnt::remove_cvref<decltype(*std::declval<It>())>::type>::value>::type
+    visit_all(parallel_policy const& policy, It first, It last, F const& f)
+  {
+    std::vector<std::thread> threads;
+    auto spawn = [&threads](std::function<void()> task) { threads.emplace_back(std::move(task)); };
+    std::exception_ptr const error{ detail::valg::Parallel(policy, spawn, first, last, f) };
+    for (std::thread& thread : threads)thread.join();
+    detail::valg::Rethrow(error);
+  }
+
+#if OWS_SMOKE_TEST
+  static_assert(64 == sizeof(OWS::detail::valg::Share), "variant algorithm: share padding failure");
+  static_assert(true == std::is_same<OWS::Variant<int> const, OWS::detail::valg::Element<std::vector<OWS::Variant<int>>::const_iterator>>::value, "variant algorithm: element failure");
+#endif // OWS_SMOKE_TEST
+}
+
+#endif // !HEADER_GUARD_OWS_VARIANT_ALGORITHM_HPP
@@ -0,0 +1,300 @@
+/*!*****************************************************************************
+ * @file    variant_ring.hpp
+ * @author  Owen Huang Wensong
+ * @date    14 OCT 2026
+ * @brief   Bounded lock free queues of variant messages for C++11.
+ *
+ * @par     Copyright (c) 2023 Owen Huang Wensong.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+*******************************************************************************/
+
+#ifndef HEADER_GUARD_OWS_VARIANT_RING_HPP
+#define HEADER_GUARD_OWS_VARIANT_RING_HPP
+
+#include "variant.hpp"
+
+#include <atomic> // head, tail, slot sequences
+
+namespace OWS
+{
+  // ***************************************************************************
+  // *************************************************************** detail ****
+
+  namespace detail
+  {
+    namespace vring
+    {
+      static constexpr size_t s_CacheLine{ 64 };
+
+      // message storage, constructed on emplace and destroyed on consume so empty slots hold no variant
+      template <typename V>
+      struct Cell
+      {
+        V& Value() noexcept { return *reinterpret_cast<V*>(&m_Storage); }
+
+        typename std::aligned_storage<sizeof(V), alignof(V)>::type m_Storage;
+      };
+
+      // multiple producers claim slots by sequence, Vyukov's bounded queue
+      template <bool MultiProducer, typename V>
+      struct alignas(s_CacheLine) Slot : public Cell<V>{};
+
+      template <typename V>
+      struct alignas(s_CacheLine) Slot<true, V> : public Cell<V>
+      {
+        std::atomic<size_t> m_Seq;
+      };
+
+      // producer and consumer counters, each on its own line with a cached copy of the other side's
+      struct alignas(s_CacheLine) Cursor
+      {
+        std::atomic<size_t> m_Pos{ 0 };
+        size_t m_Cache{ 0 };
+      };
+
+      // publishes the claimed slot on scope exit, a throwing constructor leaves it valueless for the consumer to skip
+      template <typename V, typename Publish>
+      struct EmplaceGuard
+      {
+        ~EmplaceGuard()
+        {
+          if (!m_Done)::new (static_cast<void*>(m_Value)) V{}; // the alternative never finished constructing
+          m_Publish();
+        }
+
+        V* m_Value;
+        Publish m_Publish;
+        bool m_Done;
+      };
+
+      template <typename V>
+      struct DestroyGuard
+      {
+        ~DestroyGuard() { m_Value->~V(); }
+        V* m_Value;
+      };
+    }
+  }
+
+  // *************************************************************** detail ****
+  // ***************************************************************************
+
+  // Bounded queue of Variant<Ts...> messages, N a power of two. Producers construct straight into a slot and the
+  // consumer visits the slot in place, no message is copied or moved on the way through. Single consumer,
+  // one producer unless MultiProducer. Slots are cache line padded.
+  template <bool MultiProducer, size_t N, typename... Ts>
+  class BasicVariantRing
+  {
+    using Slot = detail::vring::Slot<MultiProducer, Variant<Ts...>>;
+
+  public:
+
+    static_assert(0 != N && 0 == (N & (N - 1)), "variant ring capacity should be a power of two");
+
+    using value_type = Variant<Ts...>;
+
+    static constexpr size_t s_Capacity{ N };
+
+    BasicVariantRing() noexcept { InitSeq(std::integral_constant<bool, MultiProducer>{}); }
+
+    BasicVariantRing(BasicVariantRing const&) = delete;
+    BasicVariantRing& operator=(BasicVariantRing const&) = delete;
+
+    ~BasicVariantRing()
+    {
+      while (try_consume(Discard{})) {}
+    }
+
+    // constructs T in the next free slot, false when full
+    template <typename T, typename... Args>
+    typename std::enable_if<detail::vrnt::is_any<T, Ts...>::value, bool>::type try_emplace(Args&&... args)
+    {
+      return TryEmplace<T>(std::integral_constant<bool, MultiProducer>{}, std::forward<Args>(args)...);
+    }
+
+    template <typename T, typename U = typename std::enable_if<detail::vrnt::is_any<typename detail::vrnt::remove_cvref<T>::type, Ts...>::value, T>::type>
+    bool try_push(T&& value)
+    {
+      return try_emplace<typename detail::vrnt::remove_cvref<U>::type>(std::forward<U>(value));
+    }
+
+    // consumer only, f visits the oldest message in place, which is destroyed afterwards, false when empty
+    template <typename F>
+    bool try_consume(F&& f)
+    {
+      for (;;)
+      {
+        value_type* const value{ Front(std::integral_constant<bool, MultiProducer>{}) };
+        if (nullptr == value)return false;
+
+        bool const held{ !value->valueless() };
+        {
+          PopGuard pop{ this }; // released after the value is destroyed
+          detail::vring::DestroyGuard<value_type> destroy{ value };
+          if (held)visit(f, *value);
+        }
+        if (held)return true; // valueless slots come from throwing producers, skipped
+      }
+    }
+
+    // consumer side estimate, exact when producers are idle
+    size_t size() const noexcept
+    {
+      return m_Tail.m_Pos.load(std::memory_order_acquire) - m_Head.m_Pos.load(std::memory_order_relaxed);
+    }
+
+    bool empty() const noexcept { return 0 == size(); }
+
+  private:
+
+    static constexpr size_t s_Mask{ N - 1 };
+
+    struct Discard
+    {
+      template <typename T>
+      void operator()(T&) const noexcept {}
+    };
+
+    struct PopGuard
+    {
+      ~PopGuard() { m_Self->Pop(std::integral_constant<bool, MultiProducer>{}); }
+      BasicVariantRing* m_Self;
+    };
+
+    void InitSeq(std::false_type) noexcept {}
+
+    void InitSeq(std::true_type) noexcept
+    {
+      for (size_t i{ 0 }; i < N; ++i)m_Slots[i].m_Seq.store(i, std::memory_order_relaxed);
+    }
+
+    template <typename T, typename... Args>
+    bool Fill(value_type* value, Args&&... args)
+    {
+      ::new (static_cast<void*>(value)) value_type(in_place_type<T>, std::forward<Args>(args)...);
+      return true;
+    }
+
+    // ***** single producer *****
+
+    template <typename T, typename... Args>
+    bool TryEmplace(std::false_type, Args&&... args)
+    {
+      size_t const pos{ m_Tail.m_Pos.load(std::memory_order_relaxed) };
+      if (N == pos - m_Tail.m_Cache)
+      {
+        m_Tail.m_Cache = m_Head.m_Pos.load(std::memory_order_acquire);
+        if (N == pos - m_Tail.m_Cache)return false;
+      }
+
+      struct Publish
+      {
+        void operator()() const noexcept { m_Tail->store(m_Pos + 1, std::memory_order_release); }
+        std::atomic<size_t>* m_Tail;
+        size_t m_Pos;
+      };
+
+      value_type* const value{ &m_Slots[pos & s_Mask].Value() };
+      detail::vring::EmplaceGuard<value_type, Publish> guard{ value, Publish{ &m_Tail.m_Pos, pos }, false };
+      guard.m_Done = Fill<T>(value, std::forward<Args>(args)...);
+      return true;
+    }
+
+    value_type* Front(std::false_type) noexcept
+    {
+      size_t const pos{ m_Head.m_Pos.load(std::memory_order_relaxed) };
+      if (pos == m_Head.m_Cache)
+      {
+        m_Head.m_Cache = m_Tail.m_Pos.load(std::memory_order_acquire);
+        if (pos == m_Head.m_Cache)return nullptr;
+      }
+      return &m_Slots[pos & s_Mask].Value();
+    }
+
+    void Pop(std::false_type) noexcept
+    {
+      m_Head.m_Pos.store(m_Head.m_Pos.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+
+    // ***** multiple producers *****
+
+    template <typename T, typename... Args>
+    bool TryEmplace(std::true_type, Args&&... args)
+    {
+      size_t pos{ m_Tail.m_Pos.load(std::memory_order_relaxed) };
+      Slot* slot;
+      for (;;)
+      {
+        slot = &m_Slots[pos & s_Mask];
+        std::ptrdiff_t const diff{ static_cast<std::ptrdiff_t>(slot->m_Seq.load(std::memory_order_acquire) - pos) };
+        if (0 == diff)
+        {
+          if (m_Tail.m_Pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))break;
+        }
+        else if (diff < 0)return false; // consumer has not freed this lap's slot
+        else pos = m_Tail.m_Pos.load(std::memory_order_relaxed);
+      }
+
+      struct Publish
+      {
+        void operator()() const noexcept { m_Slot->m_Seq.store(m_Pos + 1, std::memory_order_release); }
+        Slot* m_Slot;
+        size_t m_Pos;
+      };
+
+      value_type* const value{ &slot->Value() };
+      detail::vring::EmplaceGuard<value_type, Publish> guard{ value, Publish{ slot, pos }, false };
+      guard.m_Done = Fill<T>(value, std::forward<Args>(args)...);
+      return true;
+    }
+
+    value_type* Front(std::true_type) noexcept
+    {
+      size_t const pos{ m_Head.m_Pos.load(std::memory_order_relaxed) };
+      Slot& slot{ m_Slots[pos & s_Mask] };
+      return pos + 1 == slot.m_Seq.load(std::memory_order_acquire) ? &slot.Value() : nullptr;
+    }
+
+    void Pop(std::true_type) noexcept
+    {
+      size_t const pos{ m_Head.m_Pos.load(std::memory_order_relaxed) };
+      m_Slots[pos & s_Mask].m_Seq.store(pos + N, std::memory_order_release);
+      m_Head.m_Pos.store(pos + 1, std::memory_order_relaxed);
+    }
+
+    detail::vring::Cursor m_Head; // consumer
+    detail::vring::Cursor m_Tail; // producers
+    Slot m_Slots[N];
+  };
+
+  template <size_t N, typename... Ts>
+  using VariantRing = BasicVariantRing<false, N, Ts...>;
+
+  template <size_t N, typename... Ts>
+  using MpscVariantRing = BasicVariantRing<true, N, Ts...>;
+
+#if OWS_SMOKE_TEST
+  static_assert(0 == sizeof(OWS::detail::vring::Slot<false, OWS::Variant<int, double>>) % OWS::detail::vring::s_CacheLine, "variant ring: slot padding failure");
+  static_assert(0 == sizeof(OWS::detail::vring::Slot<true, OWS::Variant<int, double>>) % OWS::detail::vring::s_CacheLine,  "variant ring: slot padding failure");
+  static_assert((2 + 4) * OWS::detail::vring::s_CacheLine == sizeof(OWS::VariantRing<4, int, double>),                    "variant ring: layout failure");
+#endif // OWS_SMOKE_TEST
+}
+
+#endif // !HEADER_GUARD_OWS_VARIANT_RING_HPP
@@ -0,0 +1,672 @@
+/*!*****************************************************************************
+ * @file    variant_serial.hpp
+ * @author  Owen Huang Wensong
+ * @date    14 OCT 2026
+ * @brief   Binary snapshots and streams of variants for C++11.
+ *
+ * @par     Copyright (c) 2023 Owen Huang Wensong.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+*******************************************************************************/
+
+#ifndef HEADER_GUARD_OWS_VARIANT_SERIAL_HPP
+#define HEADER_GUARD_OWS_VARIANT_SERIAL_HPP
+
+#include "variant.hpp"
+#include "variant_vector.hpp"
+#include "tagged_array.hpp"
+
+#include <istream>// stream reader
+#include <ostream>// snapshot and stream writers
+#include <cstring>// memcpy, memcmp
+
+namespace OWS
+{
+  // user specializable id folded into the fingerprint, tells apart alternatives of the same shape
+  template <typename T>
+  struct serial_tag : public std::integral_constant<std::uint64_t, 0>{};
+
+  // streaming encoding of one alternative, specialize for types that are not trivially copyable
+  // static void write(std::ostream&, T const&) and static T read(std::istream&), failures through the stream state
+  template <typename T, typename = void>
+  struct serial_traits;
+
+  template <typename T>
+  struct serial_traits<T, typename std::enable_if<std::is_trivially_copyable<T>::value>::type>
+  {
+    static void write(std::ostream& out, T const& value) { out.write(reinterpret_cast<char const*>(&value), sizeof(T)); }
+
+    static T read(std::istream& in)
+    {
+      typename std::aligned_storage<sizeof(T), alignof(T)>::type value{}; // trivially copyable, need not be default constructible
+      in.read(reinterpret_cast<char*>(&value), sizeof(T));
+      return *reinterpret_cast<T const*>(&value);
+    }
+  };
+
+  template <typename C, typename Traits, typename Alloc>
+  struct serial_traits<std::basic_string<C, Traits, Alloc>>
+  {
+    static_assert(true == std::is_trivially_copyable<C>::value, "serial string characters should be trivially copyable");
+
+    static void write(std::ostream& out, std::basic_string<C, Traits, Alloc> const& value)
+    {
+      std::uint64_t const length{ value.size() };
+      out.write(reinterpret_cast<char const*>(&length), sizeof(length));
+      out.write(reinterpret_cast<char const*>(value.data()), static_cast<std::streamsize>(value.size() * sizeof(C)));
+    }
+
+    // grows as characters arrive, a corrupt length fails the stream instead of allocating it up front
+    static std::basic_string<C, Traits, Alloc> read(std::istream& in)
+    {
+      std::uint64_t length{ 0 };
+      in.read(reinterpret_cast<char*>(&length), sizeof(length));
+      std::basic_string<C, Traits, Alloc> value;
+      C chunk[256];
+      while (in && length)
+      {
+        size_t const n{ length < 256 ? static_cast<size_t>(length) : 256 };
+        if (!in.read(reinterpret_cast<char*>(chunk), static_cast<std::streamsize>(n * sizeof(C))))break;
+        value.append(chunk, n);
+        length -= n;
+      }
+      return value;
+    }
+  };
+
+  // ***************************************************************************
+  // *************************************************************** detail ****
+
+  namespace detail
+  {
+    namespace vser
+    {
+      // ***** fingerprint *****
+      // FNV style fold of each alternative's kind, size, alignment and serial_tag, in order
+
+      static constexpr std::uint64_t s_Basis{ 14695981039346656037ull };
+      static constexpr std::uint64_t s_Prime{ 1099511628211ull };
+
+      constexpr std::uint64_t Fold(std::uint64_t hash) { return hash; }
+
+      template <typename... Rest>
+      constexpr std::uint64_t Fold(std::uint64_t hash, std::uint64_t value, Rest... rest) { return Fold((hash ^ value) * s_Prime, rest...); }
+
+      template <typename T>
+      constexpr std::uint64_t Kind()
+      {
+        return std::is_floating_point<T>::value ? 1 : std::is_integral<T>::value ? (std::is_signed<T>::value ? 2 : 3) :
+          std::is_enum<T>::value ? 4 : std::is_pointer<T>::value ? 5 : std::is_trivially_copyable<T>::value ? 6 : 7;
+      }
+
+      template <typename T>
+      constexpr std::uint64_t Describe() { return Fold(s_Basis, Kind<T>(), sizeof(T), alignof(T), serial_tag<T>::value); }
+
+      // ***** header *****
+
+      enum Layout : std::uint8_t
+      {
+        e_Array   = 1, // Variant objects back to back
+        e_Tagged  = 2, // tag column then payload column, TaggedArray
+        e_Columns = 3, // count table then one column per alternative, VariantVector
+        e_Stream  = 4  // index then serial_traits encoding per element
+      };
+
+      static constexpr std::uint32_t s_Endian{ 0x01020304 };
+      static constexpr size_t s_Align{ 64 }; // sections start on cache lines, page aligned maps keep every element aligned
+
+      struct Header
+      {
+        char          m_Magic[4];
+        std::uint16_t m_Version;
+        std::uint8_t  m_Layout;
+        std::uint8_t  m_IndexSize;
+        std::uint32_t m_Endian;
+        std::uint32_t m_ElementSize;
+        std::uint64_t m_Fingerprint;
+        std::uint64_t m_Count;
+        char          m_Reserved[s_Align - 32];
+      };
+
+      constexpr size_t AlignUp(size_t n) { return (n + s_Align - 1) / s_Align * s_Align; }
+
+      inline Header MakeHeader(Layout layout, size_t indexSize, size_t elementSize, std::uint64_t fingerprint, size_t count) noexcept
+      {
+        Header header;
+        std::memset(&header, 0, sizeof(Header));
+        std::memcpy(header.m_Magic, "OWSV", 4);
+        header.m_Version = 1;
+        header.m_Layout = layout;
+        header.m_IndexSize = static_cast<std::uint8_t>(indexSize);
+        header.m_Endian = s_Endian;
+        header.m_ElementSize = static_cast<std::uint32_t>(elementSize);
+        header.m_Fingerprint = fingerprint;
+        header.m_Count = count;
+        return header;
+      }
+
+      // reason the header does not describe this layout, nullptr when it does
+      inline char const* Check(Header const& header, Layout layout, size_t indexSize, size_t elementSize, std::uint64_t fingerprint) noexcept
+      {
+        if (0 != std::memcmp(header.m_Magic, "OWSV", 4))return "not a variant snapshot";
+        if (1 != header.m_Version)return "unsupported snapshot version";
+        if (s_Endian != header.m_Endian)return "snapshot written with another byte order";
+        if (layout != header.m_Layout)return "snapshot holds another container layout";
+        if (fingerprint != header.m_Fingerprint)return "snapshot written for other alternatives";
+        if (indexSize != header.m_IndexSize || elementSize != header.m_ElementSize)return "snapshot written with another variant layout";
+        return nullptr;
+      }
+
+      // header check plus section bounds and alignment, data is the start of the mapped snapshot
+      inline char const* Open(void const* data, size_t bytes, Layout layout, size_t indexSize, size_t elementSize, std::uint64_t fingerprint) noexcept
+      {
+        if (nullptr == data || bytes < sizeof(Header))return "snapshot truncated";
+        if (0 != reinterpret_cast<std::uintptr_t>(data) % alignof(Header))return "snapshot misaligned";
+        return Check(*static_cast<Header const*>(data), layout, indexSize, elementSize, fingerprint);
+      }
+
+      inline bool Aligned(void const* p, size_t align) noexcept { return 0 == reinterpret_cast<std::uintptr_t>(p) % align; }
+
+      // every tag names an alternative, dispatch tables are indexed by them unchecked
+      template <typename IndexType>
+      inline bool TagsInRange(IndexType const* tags, size_t count, size_t alternatives) noexcept
+      {
+        for (size_t i{ 0 }; i < count; ++i)if (tags[i] >= alternatives)return false;
+        return true;
+      }
+
+      template <typename... Ts>
+      inline bool IndicesInRange(Variant<Ts...> const* items, size_t count) noexcept
+      {
+        for (size_t i{ 0 }; i < count; ++i)if (!items[i].valueless() && items[i].index() >= sizeof...(Ts))return false;
+        return true;
+      }
+
+      inline void Pad(std::ostream& out, size_t written)
+      {
+        static char const zeros[s_Align]{};
+        out.write(zeros, static_cast<std::streamsize>(AlignUp(written) - written));
+      }
+
+      // Elements go out through a zeroed staging buffer, fill copying only the held alternative's bytes in,
+      // so the tail of smaller alternatives and the padding around the index are zero instead of memory leftovers.
+      // Padding inside an alternative itself is copied as it is.
+      static constexpr size_t s_StageBytes{ 4096 };
+
+      template <size_t Size, size_t Align, typename Fill>
+      void WriteStaged(std::ostream& out, size_t count, Fill fill)
+      {
+        static constexpr size_t s_PerStage{ Size < s_StageBytes ? s_StageBytes / Size : 1 };
+        typename std::aligned_storage<s_PerStage * Size, Align>::type stage;
+        unsigned char* const bytes{ reinterpret_cast<unsigned char*>(&stage) };
+        for (size_t i{ 0 }; i < count;)
+        {
+          size_t const n{ count - i < s_PerStage ? count - i : s_PerStage };
+          std::memset(bytes, 0, n * Size);
+          for (size_t j{ 0 }; j < n; ++j, ++i)fill(bytes + j * Size, i);
+          out.write(reinterpret_cast<char const*>(bytes), static_cast<std::streamsize>(n * Size));
+        }
+      }
+
+      template <typename T, typename Alloc>
+      void WriteColumn(std::ostream& out, std::vector<T, Alloc> const& column)
+      {
+        out.write(reinterpret_cast<char const*>(column.data()), static_cast<std::streamsize>(column.size() * sizeof(T)));
+        Pad(out, column.size() * sizeof(T));
+      }
+
+      template <typename... Ts>
+      struct WriteOp
+      {
+        using result_type = void;
+        using fnptr_type = void (*)(std::ostream*, Variant<Ts...> const*);
+        static constexpr size_t s_Count{ sizeof...(Ts) };
+
+        template <size_t I, typename T = typename vrnt::IthType<I, Ts...>::type>
+        static void call(std::ostream* out, Variant<Ts...> const* variant) { serial_traits<T>::write(*out, variant->template get<I>()); }
+      };
+
+      template <typename... Ts>
+      struct ReadOp
+      {
+        using result_type = void;
+        using fnptr_type = void (*)(std::istream*, Variant<Ts...>*);
+        static constexpr size_t s_Count{ sizeof...(Ts) };
+
+        template <size_t I, typename T = typename vrnt::IthType<I, Ts...>::type>
+        static void call(std::istream* in, Variant<Ts...>* variant)
+        {
+          T value{ serial_traits<T>::read(*in) };
+          if (*in)variant->template emplace<I>(std::move(value));
+        }
+      };
+    }
+  }
+
+  // *************************************************************** detail ****
+  // ***************************************************************************
+
+  // compile time identity of an alternative list, order sensitive, see OWS::serial_tag
+  template <typename V>
+  struct variant_fingerprint;
+
+  template <typename... Ts>
+  struct variant_fingerprint<Variant<Ts...>> : public std::integral_constant<std::uint64_t,
+    detail::vser::Fold(detail::vser::s_Basis, sizeof...(Ts), detail::vser::Describe<Ts>()...)>{};
+
+  // contiguous run of one alternative inside a mapped snapshot
+  template <typename T>
+  class ColumnView
+  {
+  public:
+
+    ColumnView() noexcept = default;
+    ColumnView(T const* data, size_t size) noexcept : m_Data{ data }, m_Size{ size } {}
+
+    T const* data() const noexcept { return m_Data; }
+    size_t size() const noexcept { return m_Size; }
+    bool empty() const noexcept { return 0 == m_Size; }
+    T const* begin() const noexcept { return m_Data; }
+    T const* end() const noexcept { return m_Data + m_Size; }
+    T const& operator[](size_t i) const noexcept { return m_Data[i]; }
+
+  private:
+
+    T const* m_Data{ nullptr };
+    size_t m_Size{ 0 };
+  };
+
+  // ***************************************************************************
+  // ************************************************************ snapshots ****
+  // raw dumps of trivially copyable alternatives, header then sections on 64 byte boundaries
+  // views read a snapshot in place, e.g. from mmap, without deserializing, after checking the header, bounds, alignment
+  // and that every index names an alternative, the payload bytes themselves are trusted
+
+  template <typename... Ts>
+  bool write_snapshot(std::ostream& out, Variant<Ts...> const* data, size_t count)
+  {
+    using V = Variant<Ts...>;
+    static_assert(true == std::is_trivially_copyable<V>::value, "snapshot alternatives should be trivially copyable, see VariantWriter");
+
+    detail::vser::Header const header{ detail::vser::MakeHeader(detail::vser::e_Array,
+      sizeof(typename detail::vrnt::IndexType<sizeof...(Ts)>::type), sizeof(V), variant_fingerprint<V>::value, count) };
+    out.write(reinterpret_cast<char const*>(&header), sizeof(header));
+    detail::vser::WriteStaged<sizeof(V), alignof(V)>(out, count, [data](unsigned char* at, size_t i)
+    {
+      V& staged{ *reinterpret_cast<V*>(at) };
+      if (!data[i].valueless())std::memcpy(detail::vrnt::Access::raw(staged), detail::vrnt::Access::raw(data[i]), detail::vrnt::AltSizes<Ts...>::s_Values[data[i].index()]);
+      detail::vrnt::Access::set_index(staged, data[i].index());// valueless index() narrows to the valueless marker
+    });
+    return static_cast<bool>(out);
+  }
+
+  template <typename... Ts, typename Alloc>
+  bool write_snapshot(std::ostream& out, std::vector<Variant<Ts...>, Alloc> const& variants)
+  {
+    return write_snapshot(out, variants.data(), variants.size());
+  }
+
+  template <typename... Ts>
+  bool write_snapshot(std::ostream& out, TaggedArray<Ts...> const& array)
+  {
+    using Slot = detail::vrnt::RawStorage<Ts...>;
+    using index_type = typename TaggedArray<Ts...>::index_type;
+    static_assert(true == detail::vrnt::all_of<std::is_trivially_copyable, Ts...>::value, "snapshot alternatives should be trivially copyable");
+
+    detail::vser::Header const header{ detail::vser::MakeHeader(detail::vser::e_Tagged,
+      sizeof(index_type), sizeof(Slot), variant_fingerprint<Variant<Ts...>>::value, array.size()) };
+    out.write(reinterpret_cast<char const*>(&header), sizeof(header));
+    out.write(reinterpret_cast<char const*>(array.tags()), static_cast<std::streamsize>(array.size() * sizeof(index_type)));
+    detail::vser::Pad(out, array.size() * sizeof(index_type));
+    Slot const* const slots{ static_cast<Slot const*>(array.payload()) };
+    detail::vser::WriteStaged<sizeof(Slot), alignof(Slot)>(out, array.size(), [&array, slots](unsigned char* at, size_t i)
+    {
+      std::memcpy(at, slots[i].m_Raw, detail::vrnt::AltSizes<Ts...>::s_Values[array.index(i)]);
+    });
+    return static_cast<bool>(out);
+  }
+
+  // columns only, an ordered vector's insertion order is not kept
+  template <bool Ordered, typename... Ts>
+  bool write_snapshot(std::ostream& out, BasicVariantVector<Ordered, Ts...> const& vector)
+  {
+    static_assert(true == detail::vrnt::all_of<std::is_trivially_copyable, Ts...>::value, "snapshot alternatives should be trivially copyable");
+
+    detail::vser::Header const header{ detail::vser::MakeHeader(detail::vser::e_Columns,
+      sizeof(typename detail::vrnt::IndexType<sizeof...(Ts)>::type), sizeof...(Ts), variant_fingerprint<Variant<Ts...>>::value, vector.size()) };
+    out.write(reinterpret_cast<char const*>(&header), sizeof(header));
+    std::uint64_t const counts[]{ vector.template column<Ts>().size()... };
+    out.write(reinterpret_cast<char const*>(counts), sizeof(counts));
+    detail::vser::Pad(out, sizeof(counts));
+    int unpack[]{ 0, (detail::vser::WriteColumn(out, vector.template column<Ts>()), 0)... };
+    static_cast<void>(unpack);
+    return static_cast<bool>(out);
+  }
+
+  // snapshot of Variant<Ts...> objects, iterable as Variant<Ts...> const, e.g. by OWS::visit_all
+  template <typename... Ts>
+  class VariantArrayView
+  {
+  public:
+
+    using value_type = Variant<Ts...>;
+
+    VariantArrayView() noexcept = default;
+
+    VariantArrayView(void const* data, size_t bytes) noexcept
+    {
+      m_Error = detail::vser::Open(data, bytes, detail::vser::e_Array,
+        sizeof(typename detail::vrnt::IndexType<sizeof...(Ts)>::type), sizeof(value_type), variant_fingerprint<value_type>::value);
+      if (m_Error)return;
+
+      size_t const count{ static_cast<size_t>(static_cast<detail::vser::Header const*>(data)->m_Count) };
+      char const* const items{ static_cast<char const*>(data) + sizeof(detail::vser::Header) };
+      if ((bytes - sizeof(detail::vser::Header)) / sizeof(value_type) < count)m_Error = "snapshot truncated";
+      else if (!detail::vser::Aligned(items, alignof(value_type)))m_Error = "snapshot misaligned";
+      else if (!detail::vser::IndicesInRange(reinterpret_cast<value_type const*>(items), count))m_Error = "snapshot tag out of range";
+      else
+      {
+        m_Data = reinterpret_cast<value_type const*>(items);
+        m_Size = count;
+      }
+    }
+
+    bool valid() const noexcept { return nullptr == m_Error; }
+    char const* error() const noexcept { return m_Error; }
+
+    size_t size() const noexcept { return m_Size; }
+    bool empty() const noexcept { return 0 == m_Size; }
+    value_type const* begin() const noexcept { return m_Data; }
+    value_type const* end() const noexcept { return m_Data + m_Size; }
+    value_type const& operator[](size_t i) const noexcept { return m_Data[i]; }
+
+  private:
+
+    value_type const* m_Data{ nullptr };
+    size_t m_Size{ 0 };
+    char const* m_Error{ "empty view" };
+  };
+
+  // snapshot of a TaggedArray, tag scans and element access in place
+  template <typename... Ts>
+  class TaggedArrayView
+  {
+    using Ops = detail::tarr::SlotOps<Ts...>;
+    using Slot = typename Ops::Slot;
+    using Scanner = detail::tarr::Scanner<typename detail::vrnt::IndexType<sizeof...(Ts)>::type>;
+
+  public:
+
+    using index_type = typename detail::vrnt::IndexType<sizeof...(Ts)>::type;
+
+    TaggedArrayView() noexcept = default;
+
+    TaggedArrayView(void const* data, size_t bytes) noexcept
+    {
+      m_Error = detail::vser::Open(data, bytes, detail::vser::e_Tagged, sizeof(index_type), sizeof(Slot), variant_fingerprint<Variant<Ts...>>::value);
+      if (m_Error)return;
+
+      size_t const count{ static_cast<size_t>(static_cast<detail::vser::Header const*>(data)->m_Count) };
+      size_t const tagBytes{ detail::vser::AlignUp(count * sizeof(index_type)) };
+      char const* const tags{ static_cast<char const*>(data) + sizeof(detail::vser::Header) };
+      if (bytes - sizeof(detail::vser::Header) < tagBytes || (bytes - sizeof(detail::vser::Header) - tagBytes) / sizeof(Slot) < count)m_Error = "snapshot truncated";
+      else if (!detail::vser::Aligned(tags + tagBytes, alignof(Slot)))m_Error = "snapshot misaligned";
+      else if (!detail::vser::TagsInRange(reinterpret_cast<index_type const*>(tags), count, sizeof...(Ts)))m_Error = "snapshot tag out of range";
+      else
+      {
+        m_Tags = reinterpret_cast<index_type const*>(tags);
+        m_Slots = reinterpret_cast<Slot const*>(tags + tagBytes);
+        m_Size = count;
+      }
+    }
+
+    bool valid() const noexcept { return nullptr == m_Error; }
+    char const* error() const noexcept { return m_Error; }
+
+    size_t size() const noexcept { return m_Size; }
+    bool empty() const noexcept { return 0 == m_Size; }
+    index_type const* tags() const noexcept { return m_Tags; }
+    unsigned index(size_t i) const noexcept { return m_Tags[i]; }
+
+    template <typename T>
+    bool holds_alternative(size_t i) const noexcept { return detail::vrnt::IFromType<0, T, Ts...>::value == m_Tags[i]; }
+
+    template <typename T>
+    typename std::enable_if<detail::vrnt::is_any<T, Ts...>::value, T const*>::type get_if(size_t i) const noexcept
+    {
+      return holds_alternative<T>(i) ? &Ops::template Ref<T>(m_Slots[i]) : nullptr;
+    }
+
+    template <typename T>
+    typename std::enable_if<detail::vrnt::is_any<T, Ts...>::value, T const&>::type get(size_t i) const
+    {
+      if (!holds_alternative<T>(i))detail::vrnt::BadAccess(static_cast<unsigned>(detail::vrnt::IFromType<0, T, Ts...>::value), index(i));
+      return Ops::template Ref<T>(m_Slots[i]);
+    }
+
+    template <typename F>
+    auto visit_at(size_t i, F&& f) const -> typename detail::vrnt::CommonResult<decltype(f(std::declval<Ts const&>()))...>::type
+    {
+      using R = typename detail::vrnt::CommonResult<decltype(f(std::declval<Ts const&>()))...>::type;
+      return detail::vrnt::Dispatch<typename Ops::template VisitOp<R, F, Slot const>>(m_Tags[i], &m_Slots[i], &f);
+    }
+
+    template <typename T>
+    size_t count() const noexcept { return Scanner::Count(m_Tags, m_Size, static_cast<index_type>(detail::vrnt::IFromType<0, T, Ts...>::value)); }
+
+    template <typename T>
+    size_t find_first(size_t from = 0) const noexcept { return Scanner::Find(m_Tags, from, m_Size, static_cast<index_type>(detail::vrnt::IFromType<0, T, Ts...>::value)); }
+
+  private:
+
+    index_type const* m_Tags{ nullptr };
+    Slot const* m_Slots{ nullptr };
+    size_t m_Size{ 0 };
+    char const* m_Error{ "empty view" };
+  };
+
+  // snapshot of a VariantVector, one ColumnView per alternative
+  template <typename... Ts>
+  class VariantVectorView
+  {
+    template <size_t... Is>
+    void Map(char const* at, std::uint64_t const* counts, char const* end, detail::vrnt::index_sequence<Is...>) noexcept
+    {
+      int unpack[]{ 0, (MapOne<Is>(at, counts[Is], end), 0)... };
+      static_cast<void>(unpack);
+    }
+
+    template <size_t I, typename T = typename detail::vrnt::IthType<I, Ts...>::type>
+    void MapOne(char const*& at, std::uint64_t count, char const* end) noexcept
+    {
+      if (m_Error)return;
+      if (static_cast<size_t>(end - at) / sizeof(T) < count)m_Error = "snapshot truncated";
+      else if (!detail::vser::Aligned(at, alignof(T)))m_Error = "snapshot misaligned";
+      else
+      {
+        m_Columns[I] = at;
+        m_Sizes[I] = static_cast<size_t>(count);
+        at += detail::vser::AlignUp(static_cast<size_t>(count) * sizeof(T));
+        if (at > end)at = end; // last column's padding may be cut off
+      }
+    }
+
+  public:
+
+    VariantVectorView() noexcept = default;
+
+    VariantVectorView(void const* data, size_t bytes) noexcept
+    {
+      m_Error = detail::vser::Open(data, bytes, detail::vser::e_Columns,
+        sizeof(typename detail::vrnt::IndexType<sizeof...(Ts)>::type), sizeof...(Ts), variant_fingerprint<Variant<Ts...>>::value);
+      if (m_Error)return;
+
+      char const* at{ static_cast<char const*>(data) + sizeof(detail::vser::Header) };
+      char const* const end{ static_cast<char const*>(data) + bytes };
+      size_t const table{ detail::vser::AlignUp(sizeof...(Ts) * sizeof(std::uint64_t)) };
+      if (static_cast<size_t>(end - at) < table)
+      {
+        m_Error = "snapshot truncated";
+        return;
+      }
+      std::uint64_t const* const counts{ reinterpret_cast<std::uint64_t const*>(at) };
+      Map(at + table, counts, end, typename detail::vrnt::make_index_sequence<sizeof...(Ts)>::type{});
+      if (m_Error)return;
+      for (size_t size : m_Sizes)m_Size += size;
+    }
+
+    bool valid() const noexcept { return nullptr == m_Error; }
+    char const* error() const noexcept { return m_Error; }
+
+    size_t size() const noexcept { return m_Size; }
+    bool empty() const noexcept { return 0 == m_Size; }
+
+    template <typename T>
+    typename std::enable_if<detail::vrnt::is_any<T, Ts...>::value, ColumnView<T>>::type column() const noexcept
+    {
+      return ColumnView<T>{ reinterpret_cast<T const*>(m_Columns[detail::vrnt::IFromType<0, T, Ts...>::value]), m_Sizes[detail::vrnt::IFromType<0, T, Ts...>::value] };
+    }
+
+    template <typename T, typename F>
+    void for_each_of(F&& f) const
+    {
+      for (T const& item : column<T>())f(item);
+    }
+
+    // every column back to back, in alternative order
+    template <typename F>
+    void visit_all(F&& f) const
+    {
+      int unpack[]{ 0, (for_each_of<Ts>(f), 0)... };
+      static_cast<void>(unpack);
+    }
+
+  private:
+
+    char const* m_Columns[sizeof...(Ts)]{};
+    size_t m_Sizes[sizeof...(Ts)]{};
+    size_t m_Size{ 0 };
+    char const* m_Error{ "empty view" };
+  };
+
+  // ************************************************************ snapshots ****
+  // ***************************************************************************
+
+  // ***************************************************************************
+  // ************************************************************** streams ****
+  // element by element through serial_traits, for alternatives that cannot be dumped raw
+
+  template <typename... Ts>
+  class VariantWriter
+  {
+    using index_type = typename detail::vrnt::IndexType<sizeof...(Ts)>::type;
+
+  public:
+
+    using value_type = Variant<Ts...>;
+
+    // the header carries no count, readers stop at the end of the stream
+    explicit VariantWriter(std::ostream& out) : m_Out{ &out }
+    {
+      detail::vser::Header const header{ detail::vser::MakeHeader(detail::vser::e_Stream,
+        sizeof(index_type), 0, variant_fingerprint<value_type>::value, 0) };
+      m_Out->write(reinterpret_cast<char const*>(&header), sizeof(header));
+    }
+
+    bool write(value_type const& variant)
+    {
+      index_type const idx{ variant.valueless() ? std::numeric_limits<index_type>::max() : static_cast<index_type>(variant.index()) };
+      m_Out->write(reinterpret_cast<char const*>(&idx), sizeof(idx));
+      if (!variant.valueless())detail::vrnt::Dispatch<detail::vser::WriteOp<Ts...>>(idx, m_Out, &variant);
+      return static_cast<bool>(*m_Out);
+    }
+
+    template <typename T>
+    typename std::enable_if<detail::vrnt::is_any<T, Ts...>::value, bool>::type write(T const& value)
+    {
+      index_type const idx{ static_cast<index_type>(detail::vrnt::IFromType<0, T, Ts...>::value) };
+      m_Out->write(reinterpret_cast<char const*>(&idx), sizeof(idx));
+      serial_traits<T>::write(*m_Out, value);
+      return static_cast<bool>(*m_Out);
+    }
+
+  private:
+
+    std::ostream* m_Out;
+  };
+
+  template <typename... Ts>
+  class VariantReader
+  {
+    using index_type = typename detail::vrnt::IndexType<sizeof...(Ts)>::type;
+
+  public:
+
+    using value_type = Variant<Ts...>;
+
+    explicit VariantReader(std::istream& in) : m_In{ &in }
+    {
+      detail::vser::Header header;
+      if (!m_In->read(reinterpret_cast<char*>(&header), sizeof(header)))m_Error = "stream truncated";
+      else m_Error = detail::vser::Check(header, detail::vser::e_Stream, sizeof(index_type), 0, variant_fingerprint<value_type>::value);
+    }
+
+    bool valid() const noexcept { return nullptr == m_Error; }
+    char const* error() const noexcept { return m_Error; }
+
+    // next element into out, false at the end of the stream or on a malformed element
+    bool read(value_type& out)
+    {
+      if (m_Error)return false;
+      index_type idx;
+      if (!m_In->read(reinterpret_cast<char*>(&idx), sizeof(idx)))return false;
+      if (std::numeric_limits<index_type>::max() == idx)
+      {
+        out = value_type{};
+        return true;
+      }
+      if (idx >= sizeof...(Ts))
+      {
+        m_Error = "stream holds an unknown alternative";
+        return false;
+      }
+      detail::vrnt::Dispatch<detail::vser::ReadOp<Ts...>>(idx, m_In, &out);
+      if (*m_In)return true;
+      m_Error = "stream truncated";
+      return false;
+    }
+
+  private:
+
+    std::istream* m_In;
+    char const* m_Error{ nullptr };
+  };
+
+  // ************************************************************** streams ****
+  // ***************************************************************************
+
+#if OWS_SMOKE_TEST
+  static_assert(64 == sizeof(OWS::detail::vser::Header), "variant serial: header size failure");
+  static_assert(OWS::variant_fingerprint<OWS::Variant<int, float>>::value != OWS::variant_fingerprint<OWS::Variant<float, int>>::value, "variant serial: fingerprint order failure");
+  static_assert(OWS::variant_fingerprint<OWS::Variant<int, float>>::value != OWS::variant_fingerprint<OWS::Variant<int, unsigned>>::value, "variant serial: fingerprint kind failure");
+  static_assert(OWS::variant_fingerprint<OWS::Variant<int>>::value != OWS::variant_fingerprint<OWS::Variant<int, int*>>::value, "variant serial: fingerprint count failure");
+#endif // OWS_SMOKE_TEST
+}
+
+#endif // !HEADER_GUARD_OWS_VARIANT_SERIAL_HPP
@@ -0,0 +1,186 @@
+/*!*****************************************************************************
+ * @file    variant_std.hpp
+ * @author  Owen Huang Wensong
+ * @date    14 OCT 2026
+ * @brief   Conversions between OWS::Variant and std::variant for C++17.
+ *
+ * @par     Copyright (c) 2023 Owen Huang Wensong.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+*******************************************************************************/
+
+#ifndef HEADER_GUARD_OWS_VARIANT_STD_HPP
+#define HEADER_GUARD_OWS_VARIANT_STD_HPP
+
+#include "variant.hpp"
+
+// MSVC reports __cplusplus as 199711L unless /Zc:__cplusplus is given
+#if __cplusplus >= 201703L || (defined(_MSVC_LANG) && _MSVC_LANG >= 201703L)
+
+#include <variant>  // std::variant, std::in_place_index
+#include <vector>   // bulk conversions
+#include <iterator> // iterator_traits
+
+namespace OWS
+{
+  // ***************************************************************************
+  // *************************************************************** detail ****
+
+  namespace detail
+  {
+    namespace vstd
+    {
+      template <typename V>
+      struct StdOf;
+
+      // std::variant sees the unboxed alternatives, in declaration order
+      template <typename... Ts>
+      struct StdOf<Variant<Ts...>> : public vrnt::type_identity<std::variant<typename vrnt::Unbox<typename vrnt::Stored<Ts>::type>::type...>>{};
+
+      template <typename S>
+      struct OwsOf;
+
+      template <typename... Ts>
+      struct OwsOf<std::variant<Ts...>> : public vrnt::type_identity<Variant<Ts...>>{};
+
+      // the result is built in place from the source's payload, one dispatch and one move or copy
+      template <typename V, typename S = typename StdOf<typename vrnt::remove_cvref<V>::type>::type>
+      struct ToStdOp
+      {
+        using result_type = S;
+        using fnptr_type = S (*)(V&&);
+        static constexpr size_t s_Count{ vrnt::VariantSize<V>::value };
+
+        template <size_t I>
+        static S call(V&& v)
+        {
+          return S{ std::in_place_index<I>, vrnt::Access::get<I>(std::forward<V>(v)) };
+        }
+      };
+
+      template <typename S, typename V = typename OwsOf<typename vrnt::remove_cvref<S>::type>::type>
+      struct FromStdOp
+      {
+        using result_type = V;
+        using fnptr_type = V (*)(S&&);
+        static constexpr size_t s_Count{ std::variant_size<typename vrnt::remove_cvref<S>::type>::value };
+
+        template <size_t I>
+        static V call(S&& s)
+        {
+          return V{ in_place_index<I>, std::move(*std::get_if<I>(&s)) };
+        }
+      };
+
+      // forwards the element when it is an rvalue, so a moved from std::variant is moved from here too
+      template <typename S>
+      using Payload = typename std::conditional<std::is_rvalue_reference<S&&>::value,
+        typename vrnt::remove_cvref<S>::type&&, typename vrnt::remove_cvref<S>::type const&>::type;
+    }
+  }
+
+  // *************************************************************** detail ****
+  // ***************************************************************************
+
+  // std::variant of v's alternatives holding v's payload, moved when v is an rvalue, valueless v is a bad access
+  template <typename V, typename = typename std::enable_if<detail::vrnt::is_variant<typename detail::vrnt::remove_cvref<V>::type>::value>::type>
+  inline typename detail::vstd::StdOf<typename detail::vrnt::remove_cvref<V>::type>::type to_std_variant(V&& v)
+  {
+    if (v.valueless())detail::vrnt::BadAccess("to_std_variant of valueless variant");
+    return detail::vrnt::Dispatch<detail::vstd::ToStdOp<V&&>>(v.index(), std::forward<V>(v));
+  }
+
+  // OWS::Variant holding s's payload, moved when s is an rvalue, valueless_by_exception gives a valueless variant
+  template <typename... Ts>
+  inline Variant<Ts...> from_std_variant(std::variant<Ts...> const& s)
+  {
+    if (s.valueless_by_exception())return Variant<Ts...>{};
+    return detail::vrnt::Dispatch<detail::vstd::FromStdOp<std::variant<Ts...> const&>>(s.index(), s);
+  }
+
+  template <typename... Ts>
+  inline Variant<Ts...> from_std_variant(std::variant<Ts...>&& s)
+  {
+    if (s.valueless_by_exception())return Variant<Ts...>{};
+    return detail::vrnt::Dispatch<detail::vstd::FromStdOp<std::variant<Ts...>&&>>(s.index(), std::move(s));
+  }
+
+  // Range converters, each element costs one dispatch and is built straight in the output.
+  // Elements are copied, or moved through std::make_move_iterator.
+  template <typename It, typename Out>
+  inline Out to_std_variants(It first, It last, Out out)
+  {
+    for (; first != last; ++first, ++out)*out = to_std_variant(*first);
+    return out;
+  }
+
+  template <typename It, typename Out>
+  inline Out from_std_variants(It first, It last, Out out)
+  {
+    for (; first != last; ++first, ++out)*out = from_std_variant(static_cast<detail::vstd::Payload<decltype(*first)>>(*first));
+    return out;
+  }
+
+  // whole vectors, the result reserved once, an rvalue source has its payloads moved
+  template <typename... Ts>
+  inline std::vector<typename detail::vstd::StdOf<Variant<Ts...>>::type> to_std_variants(std::vector<Variant<Ts...>> const& items)
+  {
+    std::vector<typename detail::vstd::StdOf<Variant<Ts...>>::type> result;
+    result.reserve(items.size());
+    for (Variant<Ts...> const& item : items)result.push_back(to_std_variant(item));
+    return result;
+  }
+
+  template <typename... Ts>
+  inline std::vector<typename detail::vstd::StdOf<Variant<Ts...>>::type> to_std_variants(std::vector<Variant<Ts...>>&& items)
+  {
+    std::vector<typename detail::vstd::StdOf<Variant<Ts...>>::type> result;
+    result.reserve(items.size());
+    for (Variant<Ts...>& item : items)result.push_back(to_std_variant(std::move(item)));
+    return result;
+  }
+
+  template <typename... Ts>
+  inline std::vector<Variant<Ts...>> from_std_variants(std::vector<std::variant<Ts...>> const& items)
+  {
+    std::vector<Variant<Ts...>> result;
+    result.reserve(items.size());
+    for (std::variant<Ts...> const& item : items)result.push_back(from_std_variant(item));
+    return result;
+  }
+
+  template <typename... Ts>
+  inline std::vector<Variant<Ts...>> from_std_variants(std::vector<std::variant<Ts...>>&& items)
+  {
+    std::vector<Variant<Ts...>> result;
+    result.reserve(items.size());
+    for (std::variant<Ts...>& item : items)result.push_back(from_std_variant(std::move(item)));
+    return result;
+  }
+
+#if OWS_SMOKE_TEST
+  static_assert(true == std::is_same<std::variant<int, std::string>, decltype(OWS::to_std_variant(std::declval<OWS::Variant<int, std::string>&>()))>::value,   "variant std: conversion failure");
+  static_assert(true == std::is_same<std::variant<int, char>, OWS::detail::vstd::StdOf<OWS::Variant<int, OWS::Boxed<char>>>::type>::value,                    "variant std: unboxing failure");
+  static_assert(true == std::is_same<OWS::Variant<int, float>, decltype(OWS::from_std_variant(std::declval<std::variant<int, float>>()))>::value,              "variant std: conversion failure");
+#endif // OWS_SMOKE_TEST
+}
+
+#endif // C++17
+
+#endif // !HEADER_GUARD_OWS_VARIANT_STD_HPP
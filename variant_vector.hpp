@@ -0,0 +1,331 @@
+/*!*****************************************************************************
+ * @file    variant_vector.hpp
+ * @author  Owen Huang Wensong
+ * @date    14 OCT 2026
+ * @brief   Type partitioned container of variant alternatives for C++11.
+ *
+ * @par     Copyright (c) 2023 Owen Huang Wensong.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+*******************************************************************************/
+
+#ifndef HEADER_GUARD_OWS_VARIANT_VECTOR_HPP
+#define HEADER_GUARD_OWS_VARIANT_VECTOR_HPP
+
+#include "variant.hpp"
+
+#include <vector> // per alternative columns
+
+namespace OWS
+{
+  // ***************************************************************************
+  // *************************************************************** detail ****
+
+  namespace detail
+  {
+    namespace vvec
+    {
+      // contiguous storage of the Ith alternative
+      template <size_t I, typename T>
+      struct Column{ std::vector<T> m_Items; };
+
+      template <typename Seq, typename... Ts>
+      struct Columns;
+
+      // every column as a distinct base, selected by static_cast instead of recursion
+      template <size_t... Is, typename... Ts>
+      struct Columns<vrnt::index_sequence<Is...>, Ts...> : public Column<Is, Ts>...
+      {
+        template <typename T, typename F>
+        static void Each(std::vector<T>& items, F& f) { for (T& item : items)f(item); }
+
+        template <typename T, typename F>
+        static void Each(std::vector<T> const& items, F& f) { for (T const& item : items)f(item); }
+
+        // every column back to back, in alternative order
+        template <typename F>
+        void EachColumn(F& f)
+        {
+          int unpack[]{ 0, (Each(static_cast<Column<Is, Ts>&>(*this).m_Items, f), 0)... };
+          static_cast<void>(unpack);
+        }
+
+        template <typename F>
+        void EachColumn(F& f) const
+        {
+          int unpack[]{ 0, (Each(static_cast<Column<Is, Ts> const&>(*this).m_Items, f), 0)... };
+          static_cast<void>(unpack);
+        }
+
+        void Clear() noexcept
+        {
+          int unpack[]{ 0, (static_cast<Column<Is, Ts>&>(*this).m_Items.clear(), 0)... };
+          static_cast<void>(unpack);
+        }
+
+        size_t Size() const noexcept
+        {
+          size_t sizes[]{ 0, static_cast<Column<Is, Ts> const&>(*this).m_Items.size()... };
+          size_t total{ 0 };
+          for (size_t size : sizes)total += size;
+          return total;
+        }
+      };
+
+      // insertion order entry, alternative and position within its column
+      template <typename IndexType>
+      struct OrderEntry
+      {
+        size_t    m_Pos;
+        IndexType m_Idx;
+      };
+
+      // optional insertion order index, empty when not requested
+      template <bool Ordered, typename IndexType>
+      struct OrderIndex
+      {
+        void Prepare() noexcept {}
+        void Record(IndexType, size_t) noexcept {}
+        void Clear() noexcept {}
+      };
+
+      template <typename IndexType>
+      struct OrderIndex<true, IndexType>
+      {
+        // grow before the column is touched, so Record cannot throw after an insertion
+        void Prepare()
+        {
+          if (m_Order.size() == m_Order.capacity())m_Order.reserve(m_Order.empty() ? 8 : 2 * m_Order.size());
+        }
+        void Record(IndexType idx, size_t pos) noexcept { m_Order.push_back(OrderEntry<IndexType>{ pos, idx }); }
+        void Clear() noexcept { m_Order.clear(); }
+
+        std::vector<OrderEntry<IndexType>> m_Order;
+      };
+    }
+  }
+
+  // *************************************************************** detail ****
+  // ***************************************************************************
+
+  // mutable elements of one column whose size cannot change, an ordered vector's index stays valid
+  template <typename T>
+  class ColumnSpan
+  {
+  public:
+
+    ColumnSpan() noexcept = default;
+    ColumnSpan(T* data, size_t size) noexcept : m_Data{ data }, m_Size{ size } {}
+
+    T* data() const noexcept { return m_Data; }
+    size_t size() const noexcept { return m_Size; }
+    bool empty() const noexcept { return 0 == m_Size; }
+    T* begin() const noexcept { return m_Data; }
+    T* end() const noexcept { return m_Data + m_Size; }
+    T& operator[](size_t i) const noexcept { return m_Data[i]; }
+
+  private:
+
+    T* m_Data{ nullptr };
+    size_t m_Size{ 0 };
+  };
+
+  // One contiguous vector per alternative, each alternative only pays for its own size.
+  // Ordered additionally keeps an insertion order index for visit_at / visit_ordered.
+  template <bool Ordered, typename... Ts>
+  class BasicVariantVector : private detail::vvec::OrderIndex<Ordered, typename detail::vrnt::IndexType<sizeof...(Ts)>::type>
+  {
+    using index_type = typename detail::vrnt::IndexType<sizeof...(Ts)>::type;
+    using Order = detail::vvec::OrderIndex<Ordered, index_type>;
+    using Columns = detail::vvec::Columns<typename detail::vrnt::make_index_sequence<sizeof...(Ts)>::type, Ts...>;
+
+    template <size_t I>
+    using Column = detail::vvec::Column<I, typename detail::vrnt::IthType<I, Ts...>::type>;
+
+    template <typename T>
+    using ColumnOf = detail::vvec::Column<detail::vrnt::IFromType<0, T, Ts...>::value, T>;
+
+    // the vector itself when unordered, a fixed size span when resizing would break the insertion order index
+    template <typename T>
+    using MutableColumn = typename std::conditional<Ordered, ColumnSpan<T>, std::vector<T>&>::type;
+
+    template <typename T>
+    static MutableColumn<T> Expose(std::vector<T>& items, std::false_type /* unordered */) noexcept { return items; }
+
+    template <typename T>
+    static MutableColumn<T> Expose(std::vector<T>& items, std::true_type /* ordered */) noexcept { return MutableColumn<T>{ items.data(), items.size() }; }
+
+  public:
+
+    static_assert(true == detail::vrnt::is_unique<Ts...>::value, "variant vector should have unique parameter list");
+    static_assert(false == detail::vrnt::is_any<bool, typename std::remove_cv<Ts>::type...>::value,
+      "variant vector columns are std::vector, whose bool specialization packs bits behind proxies, wrap bool in a struct");
+
+    using variant_type = Variant<Ts...>;
+
+    // ordered vectors give ColumnSpan<T>, elements may change but not their count
+    template <size_t I, typename T = typename std::enable_if<I < sizeof...(Ts), typename detail::vrnt::IthType<I, Ts...>::type>::type>
+    MutableColumn<T> column() noexcept { return Expose(static_cast<Column<I>&>(m_Columns).m_Items, std::integral_constant<bool, Ordered>{}); }
+
+    template <size_t I, typename T = typename std::enable_if<I < sizeof...(Ts), typename detail::vrnt::IthType<I, Ts...>::type>::type>
+    std::vector<T> const& column() const noexcept { return static_cast<Column<I> const&>(m_Columns).m_Items; }
+
+    template <typename T>
+    typename std::enable_if<detail::vrnt::is_any<T, Ts...>::value, MutableColumn<T>>::type column() noexcept
+    {
+      return Expose(Items<T>(), std::integral_constant<bool, Ordered>{});
+    }
+
+    template <typename T>
+    typename std::enable_if<detail::vrnt::is_any<T, Ts...>::value, std::vector<T> const&>::type column() const noexcept
+    {
+      return static_cast<ColumnOf<T> const&>(m_Columns).m_Items;
+    }
+
+    size_t size() const noexcept { return m_Columns.Size(); }
+    bool empty() const noexcept { return 0 == size(); }
+
+    template <typename T>
+    size_t size() const noexcept { return column<T>().size(); }
+
+    template <typename T>
+    void reserve(size_t count) { Items<T>().reserve(count); }
+
+    void clear() noexcept
+    {
+      m_Columns.Clear();
+      Order::Clear();
+    }
+
+    template <typename T, typename... Args>
+    typename std::enable_if<detail::vrnt::is_any<T, Ts...>::value, T>::type& emplace_back(Args&&... args)
+    {
+      std::vector<T>& items{ Items<T>() };
+      Order::Prepare();
+      items.emplace_back(std::forward<Args>(args)...);
+      Order::Record(static_cast<index_type>(detail::vrnt::IFromType<0, T, Ts...>::value), items.size() - 1);
+      return items.back();
+    }
+
+    template <typename T, typename U = typename std::enable_if<detail::vrnt::is_any<typename detail::vrnt::remove_cvref<T>::type, Ts...>::value, T>::type>
+    void push_back(T&& value)
+    {
+      emplace_back<typename detail::vrnt::remove_cvref<U>::type>(std::forward<U>(value));
+    }
+
+    // appends the held alternative to its column, single dispatch
+    void push_back(variant_type const& variant) { visit(Pusher{ this }, variant); }
+    void push_back(variant_type&& variant) { visit(Pusher{ this }, std::move(variant)); }
+
+    // f(T&) over every element of alternative T, one branch free loop
+    template <typename T, typename F>
+    void for_each_of(F&& f)
+    {
+      Columns::Each(Items<T>(), f);
+    }
+
+    template <typename T, typename F>
+    void for_each_of(F&& f) const
+    {
+      Columns::Each(column<T>(), f);
+    }
+
+    // f over every element, one loop per alternative run back to back
+    template <typename F>
+    void visit_all(F&& f) { m_Columns.EachColumn(f); }
+
+    template <typename F>
+    void visit_all(F&& f) const { m_Columns.EachColumn(f); }
+
+    // alternative index of the ith inserted element
+    template <bool O = Ordered, typename = typename std::enable_if<O>::type>
+    unsigned index_at(size_t i) const noexcept { return this->m_Order[i].m_Idx; }
+
+    // f on the ith inserted element, single dispatch
+    template <typename F, bool O = Ordered, typename = typename std::enable_if<O>::type>
+    auto visit_at(size_t i, F&& f) -> typename detail::vrnt::CommonResult<decltype(f(std::declval<Ts&>()))...>::type
+    {
+      using R = typename detail::vrnt::CommonResult<decltype(f(std::declval<Ts&>()))...>::type;
+      detail::vvec::OrderEntry<index_type> const& entry{ this->m_Order[i] };
+      return detail::vrnt::Dispatch<AtOp<R, F, BasicVariantVector>>(entry.m_Idx, this, &f, entry.m_Pos);
+    }
+
+    template <typename F, bool O = Ordered, typename = typename std::enable_if<O>::type>
+    auto visit_at(size_t i, F&& f) const -> typename detail::vrnt::CommonResult<decltype(f(std::declval<Ts const&>()))...>::type
+    {
+      using R = typename detail::vrnt::CommonResult<decltype(f(std::declval<Ts const&>()))...>::type;
+      detail::vvec::OrderEntry<index_type> const& entry{ this->m_Order[i] };
+      return detail::vrnt::Dispatch<AtOp<R, F, BasicVariantVector const>>(entry.m_Idx, this, &f, entry.m_Pos);
+    }
+
+    // f over every element in insertion order, one dispatch per element
+    template <typename F, bool O = Ordered, typename = typename std::enable_if<O>::type>
+    void visit_ordered(F&& f)
+    {
+      for (size_t i{ 0 }, count{ this->m_Order.size() }; i < count; ++i)visit_at(i, f);
+    }
+
+    template <typename F, bool O = Ordered, typename = typename std::enable_if<O>::type>
+    void visit_ordered(F&& f) const
+    {
+      for (size_t i{ 0 }, count{ this->m_Order.size() }; i < count; ++i)visit_at(i, f);
+    }
+
+  private:
+
+    template <typename T>
+    std::vector<T>& Items() noexcept { return static_cast<ColumnOf<T>&>(m_Columns).m_Items; }
+
+    struct Pusher
+    {
+      BasicVariantVector* m_Self;
+      template <typename T>
+      void operator()(T&& value) const { m_Self->push_back(std::forward<T>(value)); }
+    };
+
+    template <typename R, typename F, typename Self>
+    struct AtOp
+    {
+      using Fn = typename std::remove_reference<F>::type;
+      using result_type = R;
+      using fnptr_type = R (*)(Self*, Fn*, size_t);
+      static constexpr size_t s_Count{ sizeof...(Ts) };
+
+      template <size_t I>
+      static R call(Self* self, Fn* f, size_t pos) { return std::forward<F>(*f)(self->template column<I>()[pos]); }
+    };
+
+    Columns m_Columns;
+  };
+
+  template <typename... Ts>
+  using VariantVector = BasicVariantVector<false, Ts...>;
+
+  template <typename... Ts>
+  using OrderedVariantVector = BasicVariantVector<true, Ts...>;
+
+#if OWS_SMOKE_TEST
+  static_assert(true == std::is_same<std::vector<float>&, decltype(std::declval<OWS::VariantVector<int, float>&>().column<float>())>::value,    "variant vector: column failure");
+  static_assert(true == std::is_same<std::vector<int> const&, decltype(std::declval<OWS::VariantVector<int, float> const&>().column<0>())>::value, "variant vector: column failure");
+  static_assert(true == std::is_same<OWS::ColumnSpan<float>, decltype(std::declval<OWS::OrderedVariantVector<int, float>&>().column<float>())>::value, "variant vector: ordered column failure");
+  static_assert(sizeof(OWS::VariantVector<int, float>) < sizeof(OWS::OrderedVariantVector<int, float>), "variant vector: unordered should not carry an order index");
+#endif // OWS_SMOKE_TEST
+}
+
+#endif // !HEADER_GUARD_OWS_VARIANT_VECTOR_HPP